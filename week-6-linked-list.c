@@ -1,6 +1,73 @@
+// 서버 모드가 쓰는 lstat, S_ISSOCK 은 -std=c11 에서는 기능 매크로가 있어야
+// 선언되므로, 모든 #include 보다 먼저 정의
+#if defined(__linux__) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE
+#endif
+
+#include <errno.h>  // errno, ERANGE (입력 검사)
+#include <limits.h> // ULONG_MAX (스냅샷 버전), INT_MIN, INT_MAX (입력 검사)
+#include <stdint.h> // uintptr_t (재배치 블록 범위 검사)
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h> // strcmp, strncpy 사용
+#include <time.h>   // clock, timespec_get (벤치마크)
+
+// 입력 파이프라인(reader 스레드 + 링 버퍼)은 C11 스레드/원자 연산이 있을 때만
+#if !defined(__STDC_NO_THREADS__) && !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+#include <threads.h>
+#define HAVE_PIPELINE 1
+#endif
+
+#ifdef _WIN32
+#include <io.h> // _commit, _fileno (저널 fsync)
+#else
+#include <fcntl.h>  // open (스냅샷 교체 후 디렉터리 fsync)
+#include <unistd.h> // fsync (저널 fsync)
+#endif
+
+// 서버 모드(Unix 도메인 소켓 + epoll)는 리눅스에서만
+#ifdef __linux__
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h> // poll (부하 생성기)
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#define HAVE_SERVER 1
+#endif
+
+// MSVC 이외의 컴파일러에서도 빌드할 수 있도록 _s 함수를 표준 함수로 대체
+#ifndef _MSC_VER
+#define scanf_s scanf
+#define strncpy_s(dest, destSize, src, count) strncpy((dest), (src), (count))
+#endif
+
+// 다음에 방문할 노드를 미리 캐시로 가져오는 소프트웨어 prefetch
+#if defined(__GNUC__) || defined(__clang__)
+#define PREFETCH(addr) __builtin_prefetch(addr)
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#define PREFETCH(addr) _mm_prefetch((const char *)(addr), _MM_HINT_T0)
+#else
+#define PREFETCH(addr) ((void)0)
+#endif
+
+// 스냅샷 reader 스레드와 writer 가 함께 접근하는 필드(next, head, 버전) 용.
+// 원자 내장 함수가 없는 컴파일러에서는 일반 접근이 되므로 스냅샷은
+// writer 와 같은 스레드에서만 안전
+#if defined(__GNUC__) || defined(__clang__)
+#define LOAD_SHARED(ptr) __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+#define STORE_SHARED(ptr, value)                                               \
+  __atomic_store_n((ptr), (value), __ATOMIC_RELEASE)
+#define FULL_FENCE() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#else
+#define LOAD_SHARED(ptr) (*(ptr))
+#define STORE_SHARED(ptr, value) (*(ptr) = (value))
+#define FULL_FENCE() ((void)0)
+#endif
 
 // ----------------------------------------------------------------------------
 // 1. 프로그램에서 사용할 데이터 구조체 (친구 연락처 정보)
@@ -18,8 +85,13 @@ typedef struct Contact {
 typedef struct Node {
   void *data;        // 실제 데이터를 가리키는 void 포인터
   struct Node *next; // 다음 노드를 가리키는 포인터
+  int deleted;       // 지연 삭제 표시 (tombstone) - 1이면 없는 노드로 취급
+  unsigned long createdVersion; // 추가된 리스트 버전 (스냅샷 가시성 판단)
+  unsigned long deletedVersion; // 삭제된 리스트 버전, 살아있으면 VERSION_NONE
 } Node;
 
+#define VERSION_NONE ULONG_MAX // 아직 삭제되지 않은 노드의 deletedVersion
+
 // 연산을 위한 함수 포인터 타입 정의
 typedef void (*PrintDataFunc)(const void *data); // 데이터 출력 함수
 typedef void (*FreeDataFunc)(
@@ -30,6 +102,16 @@ typedef struct LinkedList {
   Node *head;            // 리스트의 시작 노드를 가리키는 포인터
   PrintDataFunc print;   // 데이터 출력 함수 포인터
   FreeDataFunc freeData; // 데이터 메모리 해제 함수 포인터 - 리스트 전체 삭제
+  int lazyDelete;        // 1이면 삭제 시 tombstone 표시만 하고 나중에 해제
+  double compactRatio;   // tombstone 비율이 이 값 이상이면 한 번에 정리
+  int nodeCount;         // tombstone 을 포함한 전체 노드 수
+  int tombstoneCount;    // 아직 해제되지 않은 tombstone 노드 수
+  Node *nodeBlock;       // defragmentList 가 한 번에 할당한 노드 배열
+  void *dataBlock;       // defragmentList 가 한 번에 할당한 데이터 배열
+  size_t blockCount;     // 두 블록의 원소 수
+  size_t dataSize;       // dataBlock 원소 하나의 크기
+  unsigned long version; // 변경할 때마다 1씩 증가하는 리스트 버전 (1부터)
+  struct SnapshotRegistry *snapshots; // 스냅샷 reader 등록부 (NULL 이면 꺼짐)
 } LinkedList;
 
 // Forward declaration for helper
@@ -51,8 +133,9 @@ LinkedList *createLinkedList(PrintDataFunc printFunc, FreeDataFunc freeFunc);
  * @brief 리스트의 끝에 새 데이터 추가
  * @param list 대상 연결 리스트 포인터
  * @param newData 삽입할 데이터를 가리키는 포인터 (호출자가 메모리 할당)
+ * @return 성공 시 1, 실패(메모리 부족) 시 0 (newData 는 호출자가 해제)
  */
-void insertNodeAtEnd(LinkedList *list, void *newData);
+int insertNodeAtEnd(LinkedList *list, void *newData);
 
 /**
  * @brief 리스트의 지정된 위치에 새 데이터를 삽입
@@ -71,6 +154,41 @@ int insertNodeAtPosition(LinkedList *list, void *newData, int position);
  */
 int deleteContactByName(LinkedList *list, const char *nameToDelete);
 
+/**
+ * @brief 지연 삭제(tombstone) 모드를 설정
+ * @param list 대상 연결 리스트 포인터
+ * @param enabled 1이면 지연 삭제, 0이면 즉시 해제 (켜져 있던 tombstone 은 정리)
+ * @param compactRatio 전체 노드 중 tombstone 비율이 이 값 이상이면 정리
+ */
+void setLazyDelete(LinkedList *list, int enabled, double compactRatio);
+
+/**
+ * @brief tombstone 노드를 한 번에 모두 연결 해제하고 메모리를 해제
+ * @param list 대상 연결 리스트 포인터
+ * @return 해제한 tombstone 노드 수
+ */
+int compactTombstones(LinkedList *list);
+
+/**
+ * @brief 노드와 데이터를 순회 순서대로 연속된 메모리에 다시 배치 (defragment)
+ * 재배치 후에는 순회가 메모리를 순서대로 읽으므로 캐시 미스가 크게 줄어듦.
+ * tombstone 노드는 이때 함께 정리됨
+ * @param list 대상 연결 리스트 포인터
+ * @param dataSize 노드 데이터 하나의 크기 (Contact 리스트는 sizeof(Contact)).
+ * 데이터는 이 크기만큼 memcpy 로 복사되므로 다른 메모리를 가리키면 안 됨
+ * @return 성공 시 1, 실패(메모리 부족, 스냅샷 사용 중) 시 0 - 실패해도 리스트는
+ * 그대로
+ */
+int defragmentList(LinkedList *list, size_t dataSize);
+
+/**
+ * @brief 노드 하나와 그 데이터를 해제 (defragmentList 가 만든 블록 안에 있으면
+ * 블록째 해제되므로 건너뜀). 연결 해제는 호출자가 먼저 해야 함
+ * @param list 노드가 속한 연결 리스트 포인터
+ * @param node 해제할 노드
+ */
+void releaseNode(LinkedList *list, Node *node);
+
 /**
  * @brief 리스트의 모든 데이터를 출력
  * @param list 출력할 연결 리스트 포인터
@@ -103,15 +221,439 @@ void printContact(const void *data);
  */
 void freeContactData(void *data);
 
+// ----------------------------------------------------------------------------
+// 8. 연산 저널 (append-only journal) 구조체 및 함수 프로토타입
+//    (구현은 파일 하단 8번 섹션에)
+// ----------------------------------------------------------------------------
+
+#define JOURNAL_PATH "contacts.journal"   // 연산 저널 파일
+#define SNAPSHOT_PATH "contacts.snapshot" // 압축된 스냅샷 파일
+#define JOURNAL_GROUP_SIZE 8              // 레코드 몇 개마다 fsync 할지
+#define JOURNAL_COMPACT_THRESHOLD 256     // 저널이 이 개수를 넘으면 압축
+
+// 저널에 기록되는 연산 종류
+typedef enum JournalOp {
+  JOURNAL_INSERT_END = 1, // 끝에 추가
+  JOURNAL_INSERT_AT = 2,  // 위치 지정 삽입
+  JOURNAL_DELETE_NAME = 3 // 이름으로 삭제
+} JournalOp;
+
+// 저널 레코드 (고정 크기 바이너리, 파일에 그대로 기록)
+typedef struct JournalRecord {
+  unsigned int checksum; // 나머지 필드의 체크섬 (잘린 레코드 검출용)
+  int op;                // JournalOp
+  int position;          // JOURNAL_INSERT_AT 의 위치
+  int count;             // 카톡 횟수
+  char name[20];         // 친구 이름
+} JournalRecord;
+
+// 저널/스냅샷 파일 헤더
+typedef struct JournalHeader {
+  char magic[4];           // "CJNL" 또는 "CSNP"
+  unsigned int generation; // 압축할 때마다 1씩 증가
+  int count;               // 스냅샷의 Contact 개수 (저널은 0)
+} JournalHeader;
+
+// 저널 관리 구조체
+typedef struct Journal {
+  FILE *fp;                 // 추가 모드로 열린 저널 파일
+  const char *journalPath;  // 저널 파일 경로
+  const char *snapshotPath; // 스냅샷 파일 경로
+  JournalRecord *pending;   // 아직 fsync 되지 않은 레코드 버퍼
+  int pendingCount;         // 버퍼에 쌓인 레코드 수
+  int groupSize;            // group commit 단위 (레코드 수)
+  long recordCount;         // 저널 파일에 기록된 레코드 수
+  long compactThreshold;    // 압축을 시작할 레코드 수
+  unsigned int generation;  // 현재 스냅샷/저널 세대
+  long failures; // 디스크에 남기지 못한 commit/연산 수 (누적, 호출자가 비교)
+  int diverged;  // commit 실패로 디스크가 메모리보다 뒤처졌으면 1 (다음 기록
+                 // 때 레코드 대신 리스트 전체를 스냅샷으로 저장)
+  long logged;   // journalLog 로 받은 연산 수 (누적)
+  long durable;  // 그중 commit/압축으로 디스크에 남은 것이 확인된 연산 수
+} Journal;
+
+/**
+ * @brief 저널 구조체를 생성 (파일은 replayJournal/compactJournal 에서 열림)
+ * @param journalPath 저널 파일 경로
+ * @param snapshotPath 스냅샷 파일 경로
+ * @param groupSize 레코드 몇 개마다 fsync 할지 (1이면 매 연산마다)
+ * @param compactThreshold 저널 레코드가 이 개수 이상이면 스냅샷으로 압축
+ * @return 성공 시 Journal 포인터, 실패 시 NULL
+ */
+Journal *openJournal(const char *journalPath, const char *snapshotPath,
+                     int groupSize, long compactThreshold);
+
+/**
+ * @brief 스냅샷과 저널을 읽어 리스트를 복원하고, 저널을 추가 모드로 연다
+ * @param journal 저널 포인터
+ * @param list 복원할 (비어있는) 연결 리스트
+ * @return 저장된 데이터가 있었으면 1, 없었으면(처음 실행) 0
+ */
+int replayJournal(Journal *journal, LinkedList *list);
+
+/**
+ * @brief 연산 하나를 저널 버퍼에 추가. groupSize 만큼 쌓이면 fsync 하고,
+ * 저널이 compactThreshold 를 넘으면 현재 리스트로 압축
+ * @param journal 저널 포인터 (NULL 이면 아무것도 하지 않음)
+ * @param list 연산이 반영된 현재 리스트 (압축 시 스냅샷으로 사용)
+ * @param op 연산 종류
+ * @param position JOURNAL_INSERT_AT 의 위치 (나머지 연산은 무시)
+ * @param name 친구 이름
+ * @param count 카톡 횟수 (JOURNAL_DELETE_NAME 은 무시)
+ */
+void journalLog(Journal *journal, const LinkedList *list, JournalOp op,
+                int position, const char *name, int count);
+
+/**
+ * @brief 버퍼에 쌓인 레코드를 파일에 쓰고 fsync (group commit)
+ * @return 성공 시 1, 실패 시 0
+ */
+int journalCommit(Journal *journal);
+
+/**
+ * @brief 현재 리스트를 새 스냅샷으로 저장하고 저널을 비움
+ * @param journal 저널 포인터
+ * @param list 스냅샷으로 저장할 리스트
+ * @return 성공 시 1, 실패 시 0
+ */
+int compactJournal(Journal *journal, const LinkedList *list);
+
+/**
+ * @brief 남은 레코드를 commit 하고 저널을 닫은 뒤 구조체를 해제
+ * @param journalPtr 해제할 저널 포인터의 주소 (호출 후 NULL 로 설정됨)
+ */
+void closeJournal(Journal **journalPtr);
+
+// ----------------------------------------------------------------------------
+// 9. 벤치마크 함수 프로토타입 (구현은 파일 하단 9번 섹션에)
+// ----------------------------------------------------------------------------
+
+#define TOMBSTONE_COMPACT_RATIO 0.25 // 지연 삭제 모드의 기본 정리 비율
+
+/**
+ * @brief 삭제 위주 작업에서 즉시 삭제와 지연 삭제(tombstone)의 시간을 비교
+ * @return 성공 시 0, 실패 시 1 (main 의 반환값으로 사용)
+ */
+int runDeleteBenchmark(void);
+
+/**
+ * @brief 노드가 흩어진 리스트의 순회 시간을 defragmentList 전후로 비교
+ * @return 성공 시 0, 실패 시 1 (main 의 반환값으로 사용)
+ */
+int runDefragBenchmark(void);
+
+// ----------------------------------------------------------------------------
+// 10. 입력 파이프라인 (reader 스레드 -> 링 버퍼 -> 리스트 변경) 프로토타입
+//     (구현은 파일 하단 10번 섹션에)
+// ----------------------------------------------------------------------------
+
+#define INPUT_CHUNK_SIZE 65536 // 입력을 한 번에 읽어 오는 크기 (바이트)
+#define RING_CAPACITY 4096     // 링 버퍼 크기 (2의 거듭제곱)
+#define RING_DRAIN_BATCH 256   // 변경 스레드가 한 번에 꺼내 처리하는 명령 수
+#define RING_SPIN_LIMIT 64     // 링이 비었거나 가득 찼을 때 잠들기 전 양보 횟수
+
+// 파싱된 명령 하나 (메뉴 번호와 그 입력값)
+typedef struct Command {
+  int op;        // 메뉴 번호 (1: 끝에 추가, 2: 위치 삽입, 3: 삭제, 4~6)
+  char name[20]; // 친구 이름 (1, 2, 3)
+  int count;     // 카톡 횟수 (1, 2)
+  int position;  // 삽입 위치 (2)
+} Command;
+
+// 입력을 큰 덩어리로 읽어 한 줄씩 돌려주는 버퍼 (scanf/getchar 대신 사용)
+typedef struct InputReader {
+  FILE *fp;
+  char buffer[INPUT_CHUNK_SIZE];
+  size_t pos; // 버퍼에서 다음에 읽을 위치
+  size_t len; // 버퍼에 채워진 바이트 수
+} InputReader;
+
+// 파이프라인/직렬 실행 결과 통계
+typedef struct PipelineStats {
+  long parsed;        // 파싱한 명령 수
+  long invalid;       // 형식이 잘못되어 버린 입력 수
+  long applied;       // 성공한 명령 수
+  long failed;        // 실패한 명령 수 (잘못된 위치, 없는 이름 등)
+  long batches;       // 변경 스레드가 링에서 꺼낸 묶음 수
+  long producerWaits; // 링이 가득 차서 reader 가 기다린 횟수 (backpressure)
+} PipelineStats;
+
+/**
+ * @brief 저장된 리스트를 복원하고, 없으면 초기 친구 정보를 추가
+ * @param friendList 비어있는 연락처 리스트
+ * @param journal 저널 포인터 (NULL 이면 초기 데이터만 추가)
+ */
+void loadFriendList(LinkedList *friendList, Journal *journal);
+
+/**
+ * @brief 메뉴 입력과 같은 형식(한 줄에 하나씩)의 명령 하나를 파싱
+ * @param reader 입력 버퍼
+ * @param cmd 파싱 결과를 저장할 명령
+ * @return 성공 시 1, 입력 끝(EOF 또는 0번 메뉴) 시 0, 잘못된 입력 시 -1
+ */
+int parseCommand(InputReader *reader, Command *cmd);
+
+/**
+ * @brief 명령 하나를 리스트에 적용하고 저널에 기록 (출력 없음)
+ * @param listPtr 연락처 리스트 포인터의 주소 (4번 명령은 리스트를 새로 만듦)
+ * @param journal 저널 포인터 (NULL 이면 기록하지 않음)
+ * @param cmd 적용할 명령
+ * @return 성공 시 1, 실패 시 0, 리스트 재생성 실패 시 -1
+ */
+int applyCommand(LinkedList **listPtr, Journal *journal, const Command *cmd);
+
+/**
+ * @brief 한 스레드에서 파싱과 리스트 변경을 번갈아 실행 (기존 메뉴 루프 방식)
+ */
+void runSerial(InputReader *reader, LinkedList **listPtr, Journal *journal,
+               PipelineStats *stats);
+
+/**
+ * @brief reader 스레드가 입력을 파싱해 링 버퍼에 넣고, 호출한 스레드는 링에서
+ * 명령을 묶음으로 꺼내 리스트에 적용. C11 스레드가 없으면 runSerial 로 대체
+ */
+void runPipeline(InputReader *reader, LinkedList **listPtr, Journal *journal,
+                 PipelineStats *stats);
+
+/**
+ * @brief 표준 입력의 명령을 파이프라인으로 처리하고 최종 리스트를 출력
+ * @return 모든 명령이 성공하고 저널에 남았으면 0, 아니면 1 (main 의 반환값으로
+ * 사용)
+ */
+int runPipelineMode(void);
+
+/**
+ * @brief 같은 명령 스트림을 직렬 루프와 파이프라인으로 처리한 처리량을 비교
+ * @return 성공 시 0, 실패 시 1 (main 의 반환값으로 사용)
+ */
+int runPipelineBenchmark(void);
+
+// ----------------------------------------------------------------------------
+// 11. 스냅샷 (버전 노드 + epoch 기반 해제) 구조체 및 함수 프로토타입
+//     (구현은 파일 하단 11번 섹션에)
+// ----------------------------------------------------------------------------
+
+#define MAX_SNAPSHOT_READERS 16 // 동시에 열 수 있는 스냅샷 수
+
+// 연결은 끊었지만 아직 스냅샷이 지나가고 있을 수 있어 해제를 미룬 노드
+typedef struct RetiredNode {
+  Node *node;
+  unsigned long version; // 연결을 끊은 뒤의 리스트 버전
+} RetiredNode;
+
+// 스냅샷 reader 등록부 (writer 는 하나, reader 스레드는 여러 개)
+typedef struct SnapshotRegistry {
+  unsigned long readers[MAX_SNAPSHOT_READERS]; // 각 reader 의 버전, 0이면 빈칸
+  RetiredNode *retired;   // 해제 대기 노드 (version 오름차순)
+  size_t retiredCount;    // 해제 대기 노드 수
+  size_t retiredCapacity; // retired 배열 크기
+  unsigned long *tombstoneVersions; // 남은 tombstone 의 deletedVersion
+                                    // (삭제 순서 = 오름차순, tombstoneCount 개)
+  size_t tombstoneCapacity;         // tombstoneVersions 배열 크기
+  long retiredTotal;      // 지금까지 해제를 미룬 노드 수
+  long reclaimedTotal;    // 지금까지 실제로 해제한 노드 수
+} SnapshotRegistry;
+
+// reader 가 들고 있는 스냅샷 하나
+typedef struct ListSnapshot {
+  const LinkedList *list;
+  unsigned long version; // 이 버전 시점의 리스트를 보여줌
+  int slot;              // readers 배열에서 차지한 칸
+} ListSnapshot;
+
+/**
+ * @brief 스냅샷 기능을 켬. 이후 삭제는 항상 tombstone 으로 처리되고, 연결을
+ * 끊은 노드는 그 노드를 볼 수 있는 스냅샷이 모두 닫힐 때까지 해제가 미뤄짐.
+ * reader 스레드를 시작하기 전에 writer 가 한 번 호출해야 함
+ * @param list 대상 연결 리스트 포인터
+ * @return 성공 시 1, 실패(메모리 부족) 시 0
+ */
+int enableSnapshots(LinkedList *list);
+
+/**
+ * @brief 현재 버전의 리스트를 고정한 스냅샷을 O(1)로 얻음 (reader 스레드용).
+ * 이후 writer 가 리스트를 바꿔도 스냅샷으로 보는 내용은 변하지 않음
+ * @param list 스냅샷이 켜진 연결 리스트 포인터
+ * @param snapshot 결과를 저장할 스냅샷
+ * @return 성공 시 1, 실패(스냅샷 꺼짐, 빈 칸 없음) 시 0
+ */
+int acquireSnapshot(const LinkedList *list, ListSnapshot *snapshot);
+
+/**
+ * @brief 스냅샷을 닫음. 닫은 뒤에는 스냅샷으로 얻은 노드에 접근하면 안 됨
+ */
+void releaseSnapshot(ListSnapshot *snapshot);
+
+/**
+ * @brief 스냅샷에서 보이는 첫 노드 / 다음 노드를 반환
+ * @param snapshot 열려 있는 스냅샷
+ * @param node 현재 노드 (snapshotNext)
+ * @return 스냅샷에서 보이는 노드, 없으면 NULL
+ */
+Node *snapshotFirst(const ListSnapshot *snapshot);
+Node *snapshotNext(const ListSnapshot *snapshot, const Node *node);
+
+/**
+ * @brief 스냅샷에서 보이는 노드 수를 반환
+ */
+int getSnapshotSize(const ListSnapshot *snapshot);
+
+/**
+ * @brief 스냅샷이 켜진 리스트의 모든 노드를 한 버전에 삭제 (전체 목록 삭제용).
+ * freeList 와 달리 노드를 바로 해제하지 않고 tombstone 으로 표시한 뒤 정리하므로,
+ * 열린 스냅샷은 삭제 전 목록을 끝까지 볼 수 있음
+ * @param list 스냅샷이 켜진 연결 리스트 포인터
+ * @return 성공 시 1, 실패(메모리 부족) 시 0 - 실패해도 리스트는 그대로
+ */
+int retireAllNodes(LinkedList *list);
+
+/**
+ * @brief 열려 있는 어떤 스냅샷도 지나갈 수 없게 된 해제 대기 노드를 해제
+ * (writer 전용, 리스트를 바꾸는 함수마다 호출됨. 대기 노드가 없으면 바로 반환)
+ * @param list 대상 연결 리스트 포인터
+ * @return 해제한 노드 수
+ */
+int reclaimRetired(LinkedList *list);
+
+/**
+ * @brief 열린 스냅샷 중 가장 오래된 버전을 반환 (writer 전용)
+ * @return 가장 오래된 스냅샷 버전, 열린 스냅샷이 없거나 꺼져 있으면 VERSION_NONE
+ */
+unsigned long oldestSnapshotVersion(const LinkedList *list);
+
+/**
+ * @brief 해제 대기 배열에 extra 개를 더 넣을 수 있도록 크기를 늘림
+ * @return 성공 시 1, 실패(메모리 부족) 시 0
+ */
+int reserveRetired(SnapshotRegistry *registry, size_t extra);
+
+/**
+ * @brief 새 tombstone 의 deletedVersion 을 등록부에 기록 (스냅샷 켜짐 전용)
+ * @return 성공 시 1, 실패(메모리 부족) 시 0
+ */
+int recordTombstone(LinkedList *list, unsigned long version);
+
+/**
+ * @brief 지금 compactTombstones 를 부르면 연결을 끊을 수 있는 tombstone 수.
+ * 스냅샷이 켜져 있으면 가장 오래된 스냅샷보다 먼저 삭제된 것만 셈
+ * @param list 대상 연결 리스트 포인터
+ * @return 정리 가능한 tombstone 수
+ */
+int reclaimableTombstones(const LinkedList *list);
+
+/**
+ * @brief writer 스레드가 리스트를 계속 바꾸는 동안 reader 스레드들이 스냅샷으로
+ * 합계를 구해, 각 버전에서 writer 가 기록한 합계와 같은지 확인
+ * @return 불일치가 없으면 0, 있거나 실패 시 1 (main 의 반환값으로 사용)
+ */
+int runSnapshotDemo(void);
+
+// ----------------------------------------------------------------------------
+// 12. 소켓 서버 (Unix 도메인 소켓 + epoll) 프로토타입
+//     (구현은 파일 하단 12번 섹션에)
+// ----------------------------------------------------------------------------
+//  요청 프레임: [u32 길이][u8 op][본문], 길이 = op 를 포함한 나머지 바이트 수
+//    SERVER_OP_APPEND : [i32 count][이름]
+//    SERVER_OP_INSERT : [i32 position][i32 count][이름]
+//    SERVER_OP_DELETE : [이름]
+//    SERVER_OP_SIZE, SERVER_OP_DUMP, SERVER_OP_STATS : 본문 없음
+//  응답 프레임: [u32 길이][u8 status][본문]
+//    SIZE  : [i32 살아있는 노드 수]
+//    DUMP  : [i32 n] 뒤에 n 번 [i32 count][u8 이름 길이][이름]
+//    STATS : ServerStats 필드 순서대로 [i64] 8개
+//  이름은 NUL 없이 1~19 바이트. 같은 호스트 안의 소켓이므로 정수는 호스트
+//  바이트 순서. 요청은 응답을 기다리지 않고 이어서 보낼 수 있고(pipelining),
+//  응답은 요청 순서대로 온다
+
+#define SERVER_SOCKET_PATH "contacts.sock" // 기본 소켓 경로
+#define SERVER_MAX_FRAME 64         // 요청 프레임 최대 길이 (길이 필드 제외)
+#define SERVER_READ_BUFFER 65536    // 연결마다 한 번에 읽는 최대 바이트
+#define SERVER_WRITE_LIMIT 1048576  // 못 보낸 응답이 이보다 많으면 읽기 중단
+#define SERVER_MAX_EVENTS 64        // epoll_wait 한 번에 받는 이벤트 수
+#define SERVER_JOURNAL_GROUP 4096   // 서버의 저널 버퍼 (묶음마다 commit)
+#define SERVER_COMPACT_THRESHOLD 65536 // 서버의 저널 압축 기준
+
+#define LOAD_CONNECTIONS 8    // 부하 생성기의 연결 수
+#define LOAD_REQUESTS 400000  // 부하 생성기가 보내는 전체 요청 수
+#define LOAD_DEPTH 32         // 연결마다 응답을 기다리지 않고 보내는 요청 수
+
+// 요청 종류 (1~3 은 Command 의 메뉴 번호와 같음)
+typedef enum ServerOp {
+  SERVER_OP_APPEND = 1, // 끝에 추가
+  SERVER_OP_INSERT = 2, // 위치 지정 삽입
+  SERVER_OP_DELETE = 3, // 이름으로 삭제
+  SERVER_OP_SIZE = 4,   // 크기
+  SERVER_OP_DUMP = 5,   // 전체 목록
+  SERVER_OP_STATS = 6   // 서버 통계
+} ServerOp;
+
+// 응답 상태
+typedef enum ServerStatus {
+  SERVER_OK = 0,         // 성공
+  SERVER_FAILED = 1,     // 잘못된 위치, 없는 이름 등으로 실패
+  SERVER_BAD_REQUEST = 2 // 형식이 잘못된 요청
+} ServerStatus;
+
+// 서버 통계 (SERVER_OP_STATS 응답 순서와 같음)
+typedef struct ServerStats {
+  long long connections; // 받아들인 연결 수
+  long long requests;    // 처리한 요청 수
+  long long badRequests; // 형식이 잘못된 요청 수
+  long long readBatches; // 읽기 횟수 (한 번 읽은 요청들이 한 묶음)
+  long long writeCalls;  // 응답 쓰기 횟수 (묶음마다 한 번 + 남은 것)
+  long long bytesIn;     // 받은 바이트 수
+  long long bytesOut;    // 보낸 바이트 수
+  long long listSize;    // 현재 리스트 크기 (tombstone 제외)
+} ServerStats;
+
+/**
+ * @brief 저장된 리스트를 복원하고 Unix 도메인 소켓에서 요청을 처리. SIGINT,
+ * SIGTERM 을 받으면 저널을 닫고 종료
+ * @param path 소켓 경로
+ * @return 성공 시 0, 실패 시 1 (main 의 반환값으로 사용)
+ */
+int runServer(const char *path);
+
+/**
+ * @brief 여러 연결로 요청을 pipelining 해서 보내고 처리량과 지연 시간
+ * 백분위를 출력하는 부하 생성기
+ * @param path 서버 소켓 경로
+ * @return 성공 시 0, 실패 시 1 (main 의 반환값으로 사용)
+ */
+int runLoadClient(const char *path);
+
 // ----------------------------------------------------------------------------
 // 5. 메인 함수 - 사용자 인터페이스 및 기능 호출
 // ----------------------------------------------------------------------------
 
-int main() {
-  int choice = -1;    // 사용자 선택 저장 변수
-  char nameInput[20]; // 이름 입력 버퍼
-  int countInput;     // 횟수 입력 변수
-  int positionInput;  // 위치 입력 변수
+int main(int argc, char *argv[]) {
+  int choice = -1; // 사용자 선택 저장 변수
+  Command cmd;     // 메뉴 입력으로 채우는 명령 (이름, 횟수, 위치)
+
+  // 명령행 옵션: 벤치마크 실행 후 종료
+  if (argc > 1 && strcmp(argv[1], "--bench-delete") == 0) {
+    return runDeleteBenchmark();
+  }
+  if (argc > 1 && strcmp(argv[1], "--bench-defrag") == 0) {
+    return runDefragBenchmark();
+  }
+  if (argc > 1 && strcmp(argv[1], "--bench-pipeline") == 0) {
+    return runPipelineBenchmark();
+  }
+  if (argc > 1 && strcmp(argv[1], "--snapshot-demo") == 0) {
+    return runSnapshotDemo();
+  }
+  // 서버 모드: --serve [소켓 경로], 부하 생성기: --load [소켓 경로]
+  if (argc > 1 && strcmp(argv[1], "--serve") == 0) {
+    return runServer(argc > 2 ? argv[2] : SERVER_SOCKET_PATH);
+  }
+  if (argc > 1 && strcmp(argv[1], "--load") == 0) {
+    return runLoadClient(argc > 2 ? argv[2] : SERVER_SOCKET_PATH);
+  }
+  // 파이프라인 모드: 메뉴 없이 표준 입력의 명령을 한꺼번에 처리
+  if (argc > 1 && strcmp(argv[1], "--pipeline") == 0) {
+    return runPipelineMode();
+  }
 
   printf("친구 연락처 관리 프로그램 (연결 리스트 버전 - 순서 유지)\n");
 
@@ -122,20 +664,14 @@ int main() {
     return 1;
   }
 
-  // --- 초기 친구 정보 추가 (선택 사항, 시작 시 빈 리스트로 시작 가능) ---
-  const char *initial_names[] = {"다현", "정연", "쯔위", "사나", "지효"};
-  int initial_counts[] = {200, 150, 90, 30, 15};
-  int num_initial = sizeof(initial_counts) / sizeof(initial_counts[0]);
-  for (int i = 0; i < num_initial; ++i) {
-    Contact *initialFriend = (Contact *)malloc(sizeof(Contact));
-    if (initialFriend) {
-      strncpy_s(initialFriend->name, sizeof(initialFriend->name),
-                initial_names[i], sizeof(initialFriend->name) - 1);
-      initialFriend->name[sizeof(initialFriend->name) - 1] = '\0';
-      initialFriend->count = initial_counts[i];
-      insertNodeAtEnd(friendList, initialFriend);
-    }
+  // 저널 생성 (실패해도 저장 없이 계속 진행)
+  Journal *journal = openJournal(JOURNAL_PATH, SNAPSHOT_PATH,
+                                 JOURNAL_GROUP_SIZE, JOURNAL_COMPACT_THRESHOLD);
+  if (journal == NULL) {
+    fprintf(stderr, "경고: 저널 생성 실패! 변경 내용이 저장되지 않습니다.\n");
   }
+
+  loadFriendList(friendList, journal);
   printf("초기 데이터 \n");
   printList(friendList);
   printf("-------------------------------\n");
@@ -147,6 +683,9 @@ int main() {
     printf("2: 친구 삽입 (위치 지정)\n");
     printf("3: 친구 삭제 (이름으로)\n");
     printf("4: 전체 목록 삭제\n");
+    printf("5: 지연 삭제 모드 전환 (현재: %s)\n",
+           friendList->lazyDelete ? "켜짐" : "꺼짐");
+    printf("6: 리스트 재배치 (메모리 조각 모음)\n");
     printf("0: 프로그램 종료\n");
     printf("------------\n");
     printf("선택: ");
@@ -164,16 +703,22 @@ int main() {
     while (getchar() != '\n')
       ;
 
+    // 메뉴 번호가 곧 명령 번호. 입력만 여기서 받고 변경은 applyCommand 가 수행
+    cmd.op = choice;
+    cmd.name[0] = '\0';
+    cmd.count = 0;
+    cmd.position = 0;
+
     switch (choice) {
     case 1: // 친구 추가 (끝에)
       printf("추가할 친구 이름: ");
-      if (!readLineSafe(nameInput, sizeof(nameInput))) {
+      if (!readLineSafe(cmd.name, sizeof(cmd.name))) {
         printf("이름 입력 중 오류 발생.\n");
         break;
       }
 
       printf("카톡 횟수: ");
-      if (scanf_s("%d", &countInput) != 1) {
+      if (scanf_s("%d", &cmd.count) != 1) {
         printf("횟수 입력 오류! 숫자를 입력하세요.\n");
         // Clear buffer in case of non-numeric input
         int c;
@@ -185,32 +730,24 @@ int main() {
       while ((c_after_count = getchar()) != '\n' && c_after_count != EOF)
         ;
 
-      // 새 Contact 동적 할당
-      Contact *newFriend = (Contact *)malloc(sizeof(Contact));
-      if (newFriend == NULL) {
+      // 리스트 끝에 노드 추가
+      if (applyCommand(&friendList, journal, &cmd)) {
+        printf("친구 '%s'를(을) 리스트 끝에 추가했습니다.\n", cmd.name);
+      } else {
         fprintf(stderr, "오류: 친구 데이터 메모리 할당 실패!\n");
-        break;
       }
-      strncpy_s(newFriend->name, sizeof(newFriend->name), nameInput,
-                sizeof(newFriend->name) - 1);
-      newFriend->name[sizeof(newFriend->name) - 1] = '\0'; // NULL 종단 보장
-      newFriend->count = countInput;
-
-      // 리스트 끝에 노드 추가
-      insertNodeAtEnd(friendList, newFriend);
-      printf("친구 '%s'를(을) 리스트 끝에 추가했습니다.\n", nameInput);
       printList(friendList);
       break;
 
     case 2: // 친구 삽입 (위치 지정)
       printf("삽입할 친구 이름: ");
-      if (!readLineSafe(nameInput, sizeof(nameInput))) {
+      if (!readLineSafe(cmd.name, sizeof(cmd.name))) {
         printf("이름 입력 중 오류 발생.\n");
         break;
       }
 
       printf("카톡 횟수: ");
-      if (scanf_s("%d", &countInput) != 1) {
+      if (scanf_s("%d", &cmd.count) != 1) {
         printf("횟수 입력 오류! 숫자를 입력하세요.\n");
         int c;
         while ((c = getchar()) != '\n' && c != EOF)
@@ -224,7 +761,7 @@ int main() {
 
       printf("삽입할 위치 (0부터 시작, 현재 크기: %d): ",
              getListSize(friendList));
-      if (scanf_s("%d", &positionInput) != 1) {
+      if (scanf_s("%d", &cmd.position) != 1) {
         printf("위치 입력 오류! 숫자를 입력하세요.\n");
         int c;
         while ((c = getchar()) != '\n' && c != EOF)
@@ -235,65 +772,66 @@ int main() {
       while ((c_after_pos = getchar()) != '\n' && c_after_pos != EOF)
         ;
 
-      // 새 Contact 동적 할당
-      Contact *insertFriend = (Contact *)malloc(sizeof(Contact));
-      if (insertFriend == NULL) {
-        fprintf(stderr, "오류: 친구 데이터 메모리 할당 실패!\n");
-        break; // 메뉴로 돌아감
-      }
-      strncpy_s(insertFriend->name, sizeof(insertFriend->name), nameInput,
-                sizeof(insertFriend->name) - 1);
-      insertFriend->name[sizeof(insertFriend->name) - 1] =
-          '\0'; // Null-terminate
-      insertFriend->count = countInput;
-
       // 지정된 위치에 노드 삽입 시도
-      if (insertNodeAtPosition(friendList, insertFriend, positionInput)) {
-        printf("친구 '%s'를(을) 위치 %d에 삽입했습니다.\n", nameInput,
-               positionInput);
+      if (applyCommand(&friendList, journal, &cmd)) {
+        printf("친구 '%s'를(을) 위치 %d에 삽입했습니다.\n", cmd.name,
+               cmd.position);
         printList(friendList);
       } else {
         printf("삽입 실패. 위치가 잘못되었거나 메모리 오류일 수 있습니다.\n");
-        freeContactData(insertFriend); // 삽입 실패 시 할당된 메모리 해제
       }
       break;
 
     case 3: // 친구 삭제 (이름으로)
       printf("삭제할 친구 이름: ");
-      if (!readLineSafe(nameInput, sizeof(nameInput))) {
+      if (!readLineSafe(cmd.name, sizeof(cmd.name))) {
         printf("이름 입력 중 오류 발생.\n");
         break;
       }
 
-      printf("삭제 중... '%s'\n", nameInput);
-      int deleted = deleteContactByName(friendList, nameInput);
-      if (deleted) {
-        printf("'%s' 삭제 성공.\n", nameInput);
+      printf("삭제 중... '%s'\n", cmd.name);
+      if (applyCommand(&friendList, journal, &cmd)) {
+        printf("'%s' 삭제 성공.\n", cmd.name);
       } else {
-        printf("'%s'를(을) 찾지 못했습니다.\n", nameInput);
+        printf("'%s'를(을) 찾지 못했습니다.\n", cmd.name);
       }
       printList(friendList); // 결과 출력
       break;
 
     case 4: // 전체 목록 삭제
       printf("전체 목록을 삭제합니다...\n");
-      freeList(&friendList); // 리스트의 모든 노드와 데이터 해제
-      printf("목록이 비워졌습니다. 새 리스트를 생성합니다.\n");
-      // 리스트 재생성
-      friendList = createLinkedList(printContact, freeContactData);
-      if (friendList == NULL) { // 재생성 실패 시 처리
+      // 리스트를 해제하고 새로 만든 뒤 빈 리스트를 새 스냅샷으로 저장
+      if (applyCommand(&friendList, journal, &cmd) < 0) {
         fprintf(stderr, "오류: 리스트 재생성 실패! 프로그램을 종료합니다.\n");
-        return 1; // 또는 exit(1);
+        closeJournal(&journal);
+        return 1;
       }
+      printf("목록이 비워졌습니다. 새 리스트를 생성했습니다.\n");
       printList(friendList); // 빈 리스트 출력 (확인용)
       break;
 
+    case 5: // 지연 삭제 모드 전환
+      applyCommand(&friendList, journal, &cmd);
+      printf("지연 삭제 모드를 %s.\n",
+             friendList->lazyDelete ? "켰습니다" : "껐습니다");
+      break;
+
+    case 6: // 리스트 재배치
+      if (applyCommand(&friendList, journal, &cmd)) {
+        printf("노드 %d 개를 연속된 메모리에 다시 배치했습니다.\n",
+               getListSize(friendList));
+      } else {
+        printf("재배치 실패. 메모리가 부족할 수 있습니다.\n");
+      }
+      printList(friendList);
+      break;
+
     case 0: // 프로그램 종료
       printf("프로그램을 종료합니다.\n");
       break;
 
     default: // 잘못된 선택
-      printf("잘못된 선택입니다. 메뉴에서 0-4 사이의 숫자를 입력하세요.\n");
+      printf("잘못된 선택입니다. 메뉴에서 0-6 사이의 숫자를 입력하세요.\n");
       break;
     } // switch 끝
   } // while 끝
@@ -302,11 +840,40 @@ int main() {
   // 루프 종료 시 남아있는 리스트 데이터 모두 해제
   printf("최종 리스트 정리...\n");
   freeList(&friendList); // friendList 포인터는 내부에서 NULL로 설정됨
+  closeJournal(&journal); // 남은 저널 레코드 fsync 후 닫기
   printf("메모리 해제 완료.\n");
 
   return 0;
 }
 
+// --- 저장된 리스트 복원 또는 초기 데이터 추가 ---
+void loadFriendList(LinkedList *friendList, Journal *journal) {
+  if (journal != NULL && replayJournal(journal, friendList)) {
+    printf("저장된 데이터를 복원했습니다.\n");
+  } else {
+    // --- 초기 친구 정보 추가 (선택 사항, 시작 시 빈 리스트로 시작 가능) ---
+    const char *initial_names[] = {"다현", "정연", "쯔위", "사나", "지효"};
+    int initial_counts[] = {200, 150, 90, 30, 15};
+    int num_initial = sizeof(initial_counts) / sizeof(initial_counts[0]);
+    for (int i = 0; i < num_initial; ++i) {
+      Contact *initialFriend = (Contact *)malloc(sizeof(Contact));
+      if (initialFriend) {
+        strncpy_s(initialFriend->name, sizeof(initialFriend->name),
+                  initial_names[i], sizeof(initialFriend->name) - 1);
+        initialFriend->name[sizeof(initialFriend->name) - 1] = '\0';
+        initialFriend->count = initial_counts[i];
+        if (!insertNodeAtEnd(friendList, initialFriend)) {
+          freeContactData(initialFriend);
+        }
+      }
+    }
+    // 초기 데이터를 첫 스냅샷으로 저장
+    if (journal != NULL) {
+      compactJournal(journal, friendList);
+    }
+  }
+}
+
 // ----------------------------------------------------------------------------
 // 6. Contact 이름으로 삭제하는 함수 구현
 // ----------------------------------------------------------------------------
@@ -320,30 +887,43 @@ int deleteContactByName(LinkedList *list, const char *nameToDelete) {
   Node *prev = NULL;
   Contact *contactData = NULL;
 
-  // 첫 번째 노드(head) 확인
-  contactData = (Contact *)temp->data;
-  if (contactData != NULL && strcmp(contactData->name, nameToDelete) == 0) {
-    list->head = temp->next; // 헤드 업데이트
-    if (list->freeData) {
-      list->freeData(temp->data); // Contact 데이터 해제
-    }
-    free(temp); // 노드 자체 해제
-    return 1;   // 삭제 성공
-  }
-
-  // 나머지 리스트 탐색
-  prev = temp;
-  temp = temp->next;
+  // 리스트 탐색 (tombstone 은 이미 삭제된 노드이므로 건너뜀)
   while (temp != NULL) {
+    PREFETCH(temp->next);
     contactData = (Contact *)temp->data;
-    if (contactData != NULL && strcmp(contactData->name, nameToDelete) == 0) {
-      // 찾았으면 이전 노드의 next를 현재 노드의 next로 연결
-      prev->next = temp->next;
-      // 데이터 해제 및 노드 해제
-      if (list->freeData) {
-        list->freeData(temp->data);
+    if (!temp->deleted && contactData != NULL &&
+        strcmp(contactData->name, nameToDelete) == 0) {
+      // 지연 삭제: 표시만 하고 바로 반환, 해제는 compactTombstones 에서 모아서.
+      // 스냅샷이 켜져 있으면 열린 스냅샷이 이 노드를 볼 수 있으므로 항상 표시만
+      if (list->lazyDelete || list->snapshots != NULL) {
+        if (list->snapshots != NULL &&
+            !recordTombstone(list, list->version + 1)) {
+          return 0;
+        }
+        temp->deleted = 1;
+        STORE_SHARED(&temp->deletedVersion, list->version + 1);
+        STORE_SHARED(&list->version, list->version + 1);
+        list->tombstoneCount++;
+        // 열린 스냅샷에 묶인 tombstone 은 정리해도 남으므로 비율에서 제외
+        // (제외하지 않으면 오래 열린 스냅샷이 있는 동안 삭제마다 헛된 O(n) 정리)
+        int reclaimable = reclaimableTombstones(list);
+        if (reclaimable > 0 &&
+            reclaimable >= list->compactRatio * list->nodeCount) {
+          compactTombstones(list);
+        }
+        reclaimRetired(list);
+        return 1; // 삭제 성공
+      }
+      // 찾았으면 이전 노드의 next를 현재 노드의 next로 연결 (head 면 헤드 업데이트)
+      if (prev == NULL) {
+        list->head = temp->next;
+      } else {
+        prev->next = temp->next;
       }
-      free(temp);
+      // 데이터 해제 및 노드 해제
+      releaseNode(list, temp);
+      list->nodeCount--;
+      list->version++;
       return 1; // 삭제 성공
     }
     // 못 찾았으면 다음 노드로 이동
@@ -354,6 +934,137 @@ int deleteContactByName(LinkedList *list, const char *nameToDelete) {
   return 0; // 리스트 끝까지 탐색했지만 찾지 못함
 }
 
+// --- tombstone 노드 일괄 정리 ---
+int compactTombstones(LinkedList *list) {
+  if (list == NULL || list->tombstoneCount == 0) {
+    return 0;
+  }
+
+  // 열린 스냅샷 중 가장 오래된 것보다 먼저 삭제된 tombstone 만 연결 해제 가능
+  SnapshotRegistry *registry = list->snapshots;
+  unsigned long oldest = oldestSnapshotVersion(list);
+  if (registry != NULL &&
+      !reserveRetired(registry, (size_t)list->tombstoneCount)) {
+    return 0;
+  }
+
+  int removed = 0;
+  Node **link = &list->head; // 현재 노드를 가리키는 포인터의 주소
+  while (*link != NULL) {
+    Node *current = *link;
+    if (current->deleted && current->deletedVersion <= oldest) {
+      STORE_SHARED(link, current->next); // 연결 해제
+      if (registry != NULL) {
+        // 스냅샷이 아직 이 노드 위를 지나고 있을 수 있으므로 해제는 미룸
+        RetiredNode *entry = &registry->retired[registry->retiredCount++];
+        entry->node = current;
+        entry->version = list->version + 1;
+      } else {
+        releaseNode(list, current);
+      }
+      removed++;
+    } else {
+      link = &current->next;
+    }
+  }
+  list->nodeCount -= removed;
+  list->tombstoneCount -= removed;
+  if (registry != NULL && removed > 0) {
+    // 끊은 tombstone 은 기록의 앞부분 (oldest 이하) 과 정확히 일치
+    memmove(registry->tombstoneVersions, registry->tombstoneVersions + removed,
+            sizeof(unsigned long) * (size_t)list->tombstoneCount);
+    // 이후에 열린 스냅샷은 끊긴 노드에 닿을 수 없음을 버전으로 구분
+    STORE_SHARED(&list->version, list->version + 1);
+    registry->retiredTotal += removed;
+    reclaimRetired(list);
+  }
+  return removed;
+}
+
+// --- 지연 삭제 모드 설정 ---
+void setLazyDelete(LinkedList *list, int enabled, double compactRatio) {
+  if (list == NULL) {
+    return;
+  }
+  list->lazyDelete = enabled;
+  list->compactRatio = compactRatio;
+  if (!enabled) {
+    compactTombstones(list); // 즉시 삭제 모드에서는 tombstone 을 남기지 않음
+  }
+}
+
+// --- 포인터가 [block, block + bytes) 범위 안에 있는지 확인 ---
+int isInBlock(const void *ptr, const void *block, size_t bytes) {
+  uintptr_t p = (uintptr_t)ptr;
+  uintptr_t start = (uintptr_t)block;
+  return block != NULL && p >= start && p < start + bytes;
+}
+
+// --- 노드 하나와 데이터 해제 (재배치 블록 안의 것은 블록째 해제되므로 건너뜀)
+void releaseNode(LinkedList *list, Node *node) {
+  if (list->freeData &&
+      !isInBlock(node->data, list->dataBlock,
+                 list->blockCount * list->dataSize)) {
+    list->freeData(node->data);
+  }
+  if (!isInBlock(node, list->nodeBlock, list->blockCount * sizeof(Node))) {
+    free(node);
+  }
+}
+
+// --- 노드와 데이터를 순회 순서대로 연속 배치 ---
+int defragmentList(LinkedList *list, size_t dataSize) {
+  // 노드를 옮기면 열린 스냅샷이 해제된 노드를 보게 되므로 스냅샷 사용 중에는
+  // 재배치하지 않음
+  if (list == NULL || dataSize == 0 || list->snapshots != NULL) {
+    return 0;
+  }
+  size_t count = (size_t)(list->nodeCount - list->tombstoneCount);
+  Node *nodes = NULL;
+  unsigned char *data = NULL;
+  if (count > 0) {
+    nodes = (Node *)malloc(sizeof(Node) * count);
+    data = (unsigned char *)malloc(dataSize * count);
+    if (nodes == NULL || data == NULL) {
+      fprintf(stderr, "Error: Failed to allocate memory for defragment.\n");
+      free(nodes);
+      free(data);
+      return 0;
+    }
+  }
+
+  // 1) 살아있는 노드를 순서대로 새 블록에 복사하고, 옛 노드는 해제
+  size_t i = 0;
+  Node *current = list->head;
+  while (current != NULL) {
+    Node *nextNode = current->next;
+    PREFETCH(nextNode);
+    if (!current->deleted) {
+      memcpy(data + i * dataSize, current->data, dataSize);
+      nodes[i].data = data + i * dataSize;
+      nodes[i].next = (i + 1 < count) ? &nodes[i + 1] : NULL;
+      nodes[i].deleted = 0;
+      nodes[i].createdVersion = list->version;
+      nodes[i].deletedVersion = VERSION_NONE;
+      i++;
+    }
+    releaseNode(list, current);
+    current = nextNode;
+  }
+
+  // 2) 이전 블록을 해제하고 새 블록으로 교체
+  free(list->nodeBlock);
+  free(list->dataBlock);
+  list->nodeBlock = nodes;
+  list->dataBlock = data;
+  list->blockCount = count;
+  list->dataSize = dataSize;
+  list->head = nodes;
+  list->nodeCount = (int)count;
+  list->tombstoneCount = 0;
+  return 1;
+}
+
 // ----------------------------------------------------------------------------
 // 7. 제네릭 연결 리스트 함수 구현
 // ----------------------------------------------------------------------------
@@ -367,42 +1078,62 @@ LinkedList *createLinkedList(PrintDataFunc printFunc, FreeDataFunc freeFunc) {
   list->head = NULL;
   list->print = printFunc;
   list->freeData = freeFunc;
+  list->lazyDelete = 0;
+  list->compactRatio = TOMBSTONE_COMPACT_RATIO;
+  list->nodeCount = 0;
+  list->tombstoneCount = 0;
+  list->nodeBlock = NULL;
+  list->dataBlock = NULL;
+  list->blockCount = 0;
+  list->dataSize = 0;
+  list->version = 1;
+  list->snapshots = NULL;
   return list;
 }
 
-// --- 리스트 사이즈 반환 ---
+// --- 리스트 사이즈 반환 (tombstone 제외) ---
 int getListSize(const LinkedList *list) {
   int count = 0;
   Node *current = list->head;
   while (current != NULL) {
-    count++;
+    PREFETCH(current->next);
+    if (!current->deleted) {
+      count++;
+    }
     current = current->next;
   }
   return count;
 }
 
 // --- 리스트 끝에 노드 추가 ---
-void insertNodeAtEnd(LinkedList *list, void *newData) {
+int insertNodeAtEnd(LinkedList *list, void *newData) {
   Node *newNode = (Node *)malloc(sizeof(Node));
   if (!newNode) {
     fprintf(stderr, "Error: Failed to allocate memory for new node.\n");
-    return;
+    return 0;
   }
   newNode->data = newData;
   newNode->next = NULL;
+  newNode->deleted = 0;
+  newNode->createdVersion = list->version + 1;
+  newNode->deletedVersion = VERSION_NONE;
+  list->nodeCount++;
 
   if (list->head == NULL) {
     // 빈 리스트에서의 초기화
-    list->head = newNode;
+    STORE_SHARED(&list->head, newNode);
   } else {
     // 리스트 끝까지 이동
     Node *current = list->head;
     while (current->next != NULL) {
       current = current->next;
     }
-    // 리스트 끝에 새로운 노드 연결
-    current->next = newNode;
+    // 리스트 끝에 새로운 노드 연결 (노드를 다 채운 뒤 공개)
+    STORE_SHARED(&current->next, newNode);
   }
+  STORE_SHARED(&list->version, list->version + 1);
+  reclaimRetired(list); // 스냅샷이 닫혔으면 미뤄 둔 노드 해제
+  return 1;
 }
 
 // --- 리스트의 지정된 위치에 노드 삽입 ---
@@ -423,21 +1154,22 @@ int insertNodeAtPosition(LinkedList *list, void *newData, int position) {
   }
   newNode->data = newData;
   newNode->next = NULL;
+  newNode->deleted = 0;
+  newNode->createdVersion = list->version + 1;
+  newNode->deletedVersion = VERSION_NONE;
 
   if (position == 0) {
     // 리스트의 시작 부분에 삽입
     newNode->next = list->head;
-    list->head = newNode;
+    STORE_SHARED(&list->head, newNode);
   } else {
     // 이전 노드를 찾기
     Node *current = list->head;
-    // position-1번 이전 노드 찾기
-    for (int i = 0; i < position - 1; ++i) {
-      if (current == NULL) {
-        fprintf(stderr,
-                "Error: Traversal failed unexpectedly at position %d.\n", i);
-        free(newNode); // Clean up allocated node
-        return 0;
+    int live = 0; // 지나온 노드 중 tombstone 이 아닌 노드 수
+    // position번째 살아있는 노드(삽입 위치 바로 앞 노드) 찾기
+    while (current != NULL) {
+      if (!current->deleted && ++live == position) {
+        break;
       }
       current = current->next;
     }
@@ -450,8 +1182,11 @@ int insertNodeAtPosition(LinkedList *list, void *newData, int position) {
     }
     // 삽입
     newNode->next = current->next;
-    current->next = newNode;
+    STORE_SHARED(&current->next, newNode);
   }
+  list->nodeCount++;
+  STORE_SHARED(&list->version, list->version + 1);
+  reclaimRetired(list); // 스냅샷이 닫혔으면 미뤄 둔 노드 해제
   return 1; // 성공
 }
 
@@ -468,17 +1203,22 @@ void printList(const LinkedList *list) {
     printf("[ 출력 함수가 설정되지 않았습니다 ]\n");
     return;
   }
-  if (list->head == NULL) {
-    printf("[]\n"); // 빈 리스트
+  if (list->head == NULL || list->nodeCount == list->tombstoneCount) {
+    printf("[]\n"); // 빈 리스트 (tombstone 만 남은 경우 포함)
     return;
   }
 
   Node *temp = list->head;
+  int first = 1;
   printf("[ ");
   while (temp != NULL) {
-    list->print(temp->data);
-    if (temp->next != NULL) {
-      printf(" ");
+    PREFETCH(temp->next); // 출력하는 동안 다음 노드를 미리 가져옴
+    if (!temp->deleted) {
+      if (!first) {
+        printf(" ");
+      }
+      list->print(temp->data);
+      first = 0;
     }
     temp = temp->next;
   }
@@ -503,13 +1243,23 @@ void freeList(LinkedList **listPtr) {
 
   while (current != NULL) {
     nextNode = current->next;
-    if (list->freeData) {
-      list->freeData(current->data); // 사용자 데이터 해제
-    }
-    free(current); // 노드 해제
+    PREFETCH(nextNode);
+    releaseNode(list, current); // 사용자 데이터 및 노드 해제
     current = nextNode;
   }
 
+  // 스냅샷 때문에 해제를 미뤘던 노드와 등록부 해제 (reader 는 모두 끝났어야 함)
+  if (list->snapshots != NULL) {
+    for (size_t i = 0; i < list->snapshots->retiredCount; ++i) {
+      releaseNode(list, list->snapshots->retired[i].node);
+    }
+    free(list->snapshots->retired);
+    free(list->snapshots->tombstoneVersions);
+    free(list->snapshots);
+  }
+
+  free(list->nodeBlock); // 재배치된 노드/데이터는 블록 단위로 해제
+  free(list->dataBlock);
   list->head = NULL; // 헤드 초기화
   free(list);        // 리스트 관리 구조체 해제
   *listPtr = NULL;   // 호출자 포인터를 NULL로 설정
@@ -561,4 +1311,2629 @@ void printContact(const void *data) {
  */
 void freeContactData(void *data) {
   free(data); // Contact 구조체 자체가 malloc으로 할당되었다고 가정
-} //
\ No newline at end of file
+} //
+
+// ----------------------------------------------------------------------------
+// 8. 연산 저널 (append-only journal) 구현
+// ----------------------------------------------------------------------------
+//  - 저널 파일: JournalHeader("CJNL") 뒤에 JournalRecord 가 계속 추가됨
+//  - 스냅샷 파일: JournalHeader("CSNP") 뒤에 Contact 가 count 개 저장됨
+//  - 두 파일의 generation 이 같을 때만 저널을 스냅샷 위에 적용한다.
+//    압축 중 새 스냅샷 저장 후 저널을 비우기 전에 종료되어도, 세대가 다른
+//    이전 저널은 무시되므로 같은 연산이 두 번 적용되지 않는다.
+
+/**
+ * @brief 파일 버퍼를 비우고 디스크에 기록될 때까지 대기 (fsync)
+ * @return 성공 시 1, 실패 시 0
+ */
+int syncFile(FILE *fp) {
+  if (fflush(fp) != 0) {
+    return 0;
+  }
+#ifdef _WIN32
+  return _commit(_fileno(fp)) == 0;
+#else
+  return fsync(fileno(fp)) == 0;
+#endif
+}
+
+/**
+ * @brief path 가 들어 있는 디렉터리를 fsync (rename 결과를 디스크에 남김).
+ * Windows 는 디렉터리를 열어 _commit 할 수 없고 NTFS 가 메타데이터를
+ * 저널링하므로 아무것도 하지 않음
+ * @return 성공 시 1, 실패 시 0
+ */
+int syncDirectory(const char *path) {
+#ifdef _WIN32
+  (void)path;
+  return 1;
+#else
+  char dir[256];
+  const char *slash = strrchr(path, '/');
+  if (slash == NULL) {
+    snprintf(dir, sizeof(dir), ".");
+  } else if (slash == path) {
+    snprintf(dir, sizeof(dir), "/");
+  } else {
+    snprintf(dir, sizeof(dir), "%.*s", (int)(slash - path), path);
+  }
+  int fd = open(dir, O_RDONLY);
+  if (fd < 0) {
+    return 0;
+  }
+  int ok = fsync(fd) == 0;
+  close(fd);
+  return ok;
+#endif
+}
+
+/**
+ * @brief 레코드의 checksum 필드를 제외한 나머지에 대한 FNV-1a 해시
+ */
+unsigned int journalChecksum(const JournalRecord *record) {
+  const unsigned char *bytes = (const unsigned char *)&record->op;
+  size_t length = sizeof(JournalRecord) - sizeof(record->checksum);
+  unsigned int hash = 2166136261u;
+  for (size_t i = 0; i < length; ++i) {
+    hash ^= bytes[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+/**
+ * @brief 헤더를 쓴 새 저널 파일을 만들고 fsync (기존 내용은 버림)
+ * @return 성공 시 1, 실패 시 0
+ */
+int resetJournalFile(Journal *journal) {
+  if (journal->fp != NULL) {
+    fclose(journal->fp);
+    journal->fp = NULL;
+  }
+  FILE *fp = fopen(journal->journalPath, "wb");
+  if (fp == NULL) {
+    perror("저널 파일 생성 실패");
+    return 0;
+  }
+  JournalHeader header = {{'C', 'J', 'N', 'L'}, journal->generation, 0};
+  if (fwrite(&header, sizeof(header), 1, fp) != 1 || !syncFile(fp)) {
+    perror("저널 헤더 기록 실패");
+    fclose(fp);
+    return 0;
+  }
+  journal->fp = fp;
+  journal->recordCount = 0;
+  journal->pendingCount = 0;
+  journal->diverged = 0;
+  return 1;
+}
+
+/**
+ * @brief 실패한 commit 이 남긴 불완전한 레코드를 잘라 내고 저널을 다시 엶.
+ * 잘라 내지 않으면 이후 레코드가 손상된 레코드 뒤에 붙어 복원 시 버려짐
+ * @return 성공 시 1, 실패 시 0
+ */
+int truncateJournal(Journal *journal) {
+  long offset = (long)sizeof(JournalHeader) +
+                journal->recordCount * (long)sizeof(JournalRecord);
+  fclose(journal->fp); // 버퍼에 남은 조각도 함께 버려짐 (곧 잘라 냄)
+  journal->fp = fopen(journal->journalPath, "ab");
+  if (journal->fp == NULL) {
+    perror("저널 파일 다시 열기 실패");
+    return 0;
+  }
+#ifdef _WIN32
+  int ok = _chsize(_fileno(journal->fp), offset) == 0;
+#else
+  int ok = ftruncate(fileno(journal->fp), (off_t)offset) == 0;
+#endif
+  if (!ok || !syncFile(journal->fp)) {
+    perror("저널 잘라 내기 실패");
+    return 0;
+  }
+  return 1;
+}
+
+/**
+ * @brief tail 뒤에 새 노드를 바로 연결 (복원 시 O(1) 추가용)
+ * @param list 대상 리스트
+ * @param tail 현재 마지막 노드 (NULL 이면 끝까지 탐색)
+ * @param data 추가할 데이터
+ * @return 새 마지막 노드, 실패 시 NULL
+ */
+Node *appendNodeAfter(LinkedList *list, Node *tail, void *data) {
+  Node *newNode = (Node *)malloc(sizeof(Node));
+  if (!newNode) {
+    fprintf(stderr, "Error: Failed to allocate memory for new node.\n");
+    return NULL;
+  }
+  newNode->data = data;
+  newNode->next = NULL;
+  newNode->deleted = 0;
+  newNode->createdVersion = list->version + 1;
+  newNode->deletedVersion = VERSION_NONE;
+  list->nodeCount++;
+
+  if (tail == NULL && list->head != NULL) {
+    tail = list->head;
+    while (tail->next != NULL) {
+      tail = tail->next;
+    }
+  }
+  if (tail == NULL) {
+    STORE_SHARED(&list->head, newNode);
+  } else {
+    STORE_SHARED(&tail->next, newNode);
+  }
+  STORE_SHARED(&list->version, list->version + 1);
+  reclaimRetired(list); // 스냅샷이 닫혔으면 미뤄 둔 노드 해제
+  return newNode;
+}
+
+/**
+ * @brief name/count 로 새 Contact 를 할당
+ * @return 성공 시 Contact 포인터, 실패 시 NULL
+ */
+Contact *createContact(const char *name, int count) {
+  Contact *contact = (Contact *)malloc(sizeof(Contact));
+  if (contact == NULL) {
+    fprintf(stderr, "오류: 친구 데이터 메모리 할당 실패!\n");
+    return NULL;
+  }
+  strncpy_s(contact->name, sizeof(contact->name), name,
+            sizeof(contact->name) - 1);
+  contact->name[sizeof(contact->name) - 1] = '\0';
+  contact->count = count;
+  return contact;
+}
+
+Journal *openJournal(const char *journalPath, const char *snapshotPath,
+                     int groupSize, long compactThreshold) {
+  if (groupSize < 1) {
+    groupSize = 1;
+  }
+  Journal *journal = (Journal *)malloc(sizeof(Journal));
+  if (journal == NULL) {
+    perror("저널 구조체 메모리 할당 실패");
+    return NULL;
+  }
+  journal->pending = (JournalRecord *)malloc(sizeof(JournalRecord) * groupSize);
+  if (journal->pending == NULL) {
+    perror("저널 버퍼 메모리 할당 실패");
+    free(journal);
+    return NULL;
+  }
+  journal->fp = NULL;
+  journal->journalPath = journalPath;
+  journal->snapshotPath = snapshotPath;
+  journal->pendingCount = 0;
+  journal->groupSize = groupSize;
+  journal->recordCount = 0;
+  journal->compactThreshold = compactThreshold;
+  journal->generation = 0;
+  journal->failures = 0;
+  journal->diverged = 0;
+  journal->logged = 0;
+  journal->durable = 0;
+  return journal;
+}
+
+int replayJournal(Journal *journal, LinkedList *list) {
+  int restored = 0;
+  int needsCompaction = 0; // 저널 끝이 손상된 경우 압축으로 정리
+  Node *tail = NULL;       // 마지막 노드 캐시 (NULL 이면 다시 탐색)
+  JournalHeader header;
+
+  // --- 1) 스냅샷 읽기 ---
+  FILE *fp = fopen(journal->snapshotPath, "rb");
+  if (fp != NULL) {
+    if (fread(&header, sizeof(header), 1, fp) == 1 &&
+        memcmp(header.magic, "CSNP", 4) == 0) {
+      restored = 1;
+      journal->generation = header.generation;
+      Contact buffer;
+      for (int i = 0; i < header.count; ++i) {
+        if (fread(&buffer, sizeof(Contact), 1, fp) != 1) {
+          fprintf(stderr, "경고: 스냅샷이 %d번째 항목에서 잘렸습니다.\n", i);
+          break;
+        }
+        Contact *contact = createContact(buffer.name, buffer.count);
+        if (contact == NULL) {
+          break;
+        }
+        Node *newTail = appendNodeAfter(list, tail, contact);
+        if (newTail == NULL) {
+          freeContactData(contact);
+          break;
+        }
+        tail = newTail;
+      }
+    } else {
+      fprintf(stderr, "경고: 스냅샷 헤더가 올바르지 않아 무시합니다.\n");
+    }
+    fclose(fp);
+  }
+
+  // --- 2) 같은 세대의 저널 레코드 적용 ---
+  fp = fopen(journal->journalPath, "rb");
+  if (fp != NULL) {
+    if (fread(&header, sizeof(header), 1, fp) == 1 &&
+        memcmp(header.magic, "CJNL", 4) == 0 &&
+        header.generation == journal->generation) {
+      restored = 1;
+      JournalRecord record;
+      size_t got;
+      while ((got = fread(&record, 1, sizeof(record), fp)) == sizeof(record)) {
+        if (record.checksum != journalChecksum(&record)) {
+          got = 1; // 손상된 레코드 - 이후는 모두 버림
+          break;
+        }
+        record.name[sizeof(record.name) - 1] = '\0';
+        journal->recordCount++;
+
+        if (record.op == JOURNAL_DELETE_NAME) {
+          deleteContactByName(list, record.name);
+          tail = NULL; // 마지막 노드가 삭제됐을 수 있음
+          continue;
+        }
+        Contact *contact = createContact(record.name, record.count);
+        if (contact == NULL) {
+          continue;
+        }
+        if (record.op == JOURNAL_INSERT_END) {
+          Node *newTail = appendNodeAfter(list, tail, contact);
+          if (newTail == NULL) {
+            freeContactData(contact);
+          } else {
+            tail = newTail;
+          }
+        } else if (!insertNodeAtPosition(list, contact, record.position)) {
+          freeContactData(contact);
+        } else {
+          tail = NULL;
+        }
+      }
+      if (got != 0) {
+        fprintf(stderr, "경고: 저널 끝의 불완전한 레코드를 버립니다.\n");
+        needsCompaction = 1;
+      }
+    } else {
+      // 이전 세대의 저널 (압축 도중 종료) 이거나 손상된 헤더
+      needsCompaction = 1;
+    }
+    fclose(fp);
+  } else if (restored) {
+    needsCompaction = 1; // 스냅샷만 있고 저널이 없음
+  }
+
+  // --- 3) 이후 연산을 기록할 저널 열기 ---
+  if (!restored) {
+    return 0; // 처음 실행 - 호출자가 초기 데이터 저장 후 compactJournal 호출
+  }
+  if (needsCompaction) {
+    compactJournal(journal, list);
+  } else {
+    journal->fp = fopen(journal->journalPath, "ab");
+    if (journal->fp == NULL) {
+      perror("저널 파일 열기 실패");
+    }
+  }
+  return 1;
+}
+
+int journalCommit(Journal *journal) {
+  if (journal == NULL || journal->fp == NULL || journal->pendingCount == 0) {
+    return 1;
+  }
+  size_t written = fwrite(journal->pending, sizeof(JournalRecord),
+                          journal->pendingCount, journal->fp);
+  int complete = written == (size_t)journal->pendingCount;
+  int count = journal->pendingCount;
+  journal->pendingCount = 0;
+  if (!complete || !syncFile(journal->fp)) {
+    // 일부만 쓰였어도 실패. 파일은 마지막으로 commit 한 위치로 되돌리고,
+    // 버퍼의 연산은 메모리에만 있으므로 다음 기록 때 스냅샷으로 맞춤
+    perror("저널 기록 실패");
+    journal->failures++;
+    journal->diverged = 1;
+    truncateJournal(journal);
+    return 0;
+  }
+  journal->recordCount += count;
+  journal->durable = journal->logged; // 실패 후에는 버퍼가 비어 있어 압축으로만 옴
+  return 1;
+}
+
+void journalLog(Journal *journal, const LinkedList *list, JournalOp op,
+                int position, const char *name, int count) {
+  if (journal == NULL || name == NULL) {
+    return;
+  }
+  journal->logged++;
+  // 이전 commit/압축이 실패해 버퍼가 가득 차 있으면 먼저 비움
+  if (journal->fp != NULL && journal->pendingCount >= journal->groupSize) {
+    journalCommit(journal);
+  }
+  // 디스크가 메모리를 놓쳤으면 (commit 실패, 저널 파일 없음) 레코드를 덧붙여도
+  // 복원할 수 없으므로, 이 연산까지 반영된 리스트 전체를 스냅샷으로 저장
+  if (journal->fp == NULL || journal->diverged) {
+    if (!compactJournal(journal, list)) {
+      journal->failures++;
+    }
+    return;
+  }
+  JournalRecord *record = &journal->pending[journal->pendingCount];
+  memset(record, 0, sizeof(JournalRecord)); // 패딩/이름 뒷부분까지 결정적으로
+  record->op = op;
+  record->position = position;
+  record->count = count;
+  strncpy_s(record->name, sizeof(record->name), name,
+            sizeof(record->name) - 1);
+  record->name[sizeof(record->name) - 1] = '\0';
+  record->checksum = journalChecksum(record);
+  journal->pendingCount++;
+
+  // 저널이 너무 길어지면 리스트 전체를 스냅샷으로 압축 (버퍼 내용도 포함됨)
+  if (journal->recordCount + journal->pendingCount >=
+      journal->compactThreshold) {
+    if (!compactJournal(journal, list)) {
+      journalCommit(journal); // 압축에 실패하면 저널에라도 기록
+    }
+    return;
+  }
+  // group commit: groupSize 개가 모일 때마다 한 번만 fsync
+  if (journal->pendingCount >= journal->groupSize) {
+    journalCommit(journal);
+  }
+}
+
+int compactJournal(Journal *journal, const LinkedList *list) {
+  if (journal == NULL || list == NULL) {
+    return 0;
+  }
+
+  // 임시 파일에 새 세대의 스냅샷을 쓰고 fsync
+  char tempPath[256];
+  snprintf(tempPath, sizeof(tempPath), "%s.tmp", journal->snapshotPath);
+  FILE *fp = fopen(tempPath, "wb");
+  if (fp == NULL) {
+    perror("스냅샷 파일 생성 실패");
+    return 0;
+  }
+  JournalHeader header = {{'C', 'S', 'N', 'P'}, journal->generation + 1,
+                          getListSize(list)};
+  int ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+  for (Node *current = list->head; ok && current != NULL;
+       current = current->next) {
+    if (!current->deleted) {
+      ok = fwrite(current->data, sizeof(Contact), 1, fp) == 1;
+    }
+  }
+  ok = ok && syncFile(fp);
+  fclose(fp);
+  if (!ok) {
+    perror("스냅샷 기록 실패");
+    remove(tempPath);
+    return 0;
+  }
+
+  // 스냅샷 교체 후 저널을 새 세대로 비움
+#ifdef _WIN32
+  remove(journal->snapshotPath); // Windows 의 rename 은 덮어쓰지 않음
+#endif
+  if (rename(tempPath, journal->snapshotPath) != 0) {
+    perror("스냅샷 교체 실패");
+    remove(tempPath);
+    return 0;
+  }
+  // 교체가 디스크에 남기 전에 저널을 비우면, 충돌 후 옛 스냅샷과 빈 새 세대
+  // 저널이 짝지어져 그 사이 연산이 사라지므로 디렉터리까지 fsync
+  if (!syncDirectory(journal->snapshotPath)) {
+    perror("경고: 스냅샷 디렉터리 fsync 실패");
+  }
+  // 새 스냅샷에 지금까지의 연산이 모두 들어 있음 (이후 저널 초기화가 실패해도
+  // 복원 시 세대가 다른 저널은 무시되므로 스냅샷 그대로 복원됨)
+  journal->durable = journal->logged;
+  journal->generation++;
+  return resetJournalFile(journal);
+}
+
+void closeJournal(Journal **journalPtr) {
+  if (journalPtr == NULL || *journalPtr == NULL) {
+    return;
+  }
+  Journal *journal = *journalPtr;
+  journalCommit(journal);
+  if (journal->fp != NULL) {
+    fclose(journal->fp);
+  }
+  free(journal->pending);
+  free(journal);
+  *journalPtr = NULL;
+}
+
+// ----------------------------------------------------------------------------
+// 9. 벤치마크 구현
+// ----------------------------------------------------------------------------
+
+/**
+ * @brief 벤치마크용 xorshift 난수 (rand 의 RAND_MAX 가 작은 환경 대비)
+ */
+unsigned int benchRandom(unsigned int *state) {
+  unsigned int x = *state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *state = x;
+  return x;
+}
+
+/**
+ * @brief 이름이 "c<번호>" 인 Contact size 개로 리스트를 만든다 (O(n))
+ * @return 성공 시 리스트 포인터, 실패 시 NULL
+ */
+LinkedList *buildBenchList(int size) {
+  LinkedList *list = createLinkedList(printContact, freeContactData);
+  if (list == NULL) {
+    return NULL;
+  }
+  Node *tail = NULL;
+  char name[20];
+  for (int i = 0; i < size; ++i) {
+    snprintf(name, sizeof(name), "c%d", i);
+    Contact *contact = createContact(name, i);
+    Node *newTail = contact ? appendNodeAfter(list, tail, contact) : NULL;
+    if (newTail == NULL) {
+      freeContactData(contact);
+      freeList(&list);
+      return NULL;
+    }
+    tail = newTail;
+  }
+  return list;
+}
+
+/**
+ * @brief 삭제 위주 작업 한 번을 실행하고 걸린 시간(초)을 반환
+ * @param lazy 지연 삭제 모드 여부
+ * @param ratio 지연 삭제 모드의 정리 비율
+ * @param randomOrder 1이면 무작위 순서, 0이면 오래된(앞쪽) 항목부터 삭제
+ * @return 걸린 시간(초), 실패 시 음수
+ */
+double timeDeleteWorkload(int size, int lazy, double ratio, int randomOrder) {
+  LinkedList *list = buildBenchList(size);
+  int *order = (int *)malloc(sizeof(int) * size);
+  if (list == NULL || order == NULL) {
+    freeList(&list);
+    free(order);
+    return -1.0;
+  }
+  // 삭제 순서 (같은 seed 로 모든 모드가 같은 순서를 사용)
+  unsigned int seed = 12345u;
+  for (int i = 0; i < size; ++i) {
+    order[i] = i;
+  }
+  for (int i = size - 1; randomOrder && i > 0; --i) {
+    int j = (int)(benchRandom(&seed) % (unsigned int)(i + 1));
+    int t = order[i];
+    order[i] = order[j];
+    order[j] = t;
+  }
+  setLazyDelete(list, lazy, ratio);
+
+  // 90% 를 삭제하면서 삭제 10번마다 새 항목 하나를 끝에 추가
+  char name[20];
+  int deletes = size - size / 10;
+  clock_t start = clock();
+  for (int i = 0; i < deletes; ++i) {
+    snprintf(name, sizeof(name), "c%d", order[i]);
+    deleteContactByName(list, name);
+    if (i % 10 == 9) {
+      snprintf(name, sizeof(name), "n%d", i);
+      Contact *contact = createContact(name, i);
+      if (contact != NULL && !insertNodeAtEnd(list, contact)) {
+        freeContactData(contact);
+      }
+    }
+  }
+  compactTombstones(list); // 남은 tombstone 정리까지 포함해서 측정
+  double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+  freeList(&list);
+  free(order);
+  return seconds;
+}
+
+int runDeleteBenchmark(void) {
+  const int size = 20000;
+  const double ratios[] = {0.1, 0.25, 0.5};
+  const char *orderNames[] = {"앞쪽부터", "무작위"};
+
+  printf("삭제 위주 벤치마크: %d 개 중 90%% 삭제 (삭제 10번마다 추가 1번)\n",
+         size);
+  for (int randomOrder = 0; randomOrder <= 1; ++randomOrder) {
+    printf("\n[삭제 순서: %s]\n", orderNames[randomOrder]);
+    double eager = timeDeleteWorkload(size, 0, 0.0, randomOrder);
+    if (eager < 0) {
+      fprintf(stderr, "오류: 벤치마크 메모리 할당 실패!\n");
+      return 1;
+    }
+    printf("  즉시 삭제                : %8.3f ms\n", eager * 1000.0);
+    for (int i = 0; i < (int)(sizeof(ratios) / sizeof(ratios[0])); ++i) {
+      double lazy = timeDeleteWorkload(size, 1, ratios[i], randomOrder);
+      printf("  지연 삭제 (정리 비율 %.2f): %8.3f ms (즉시 삭제 대비 %.2fx)\n",
+             ratios[i], lazy * 1000.0, lazy > 0 ? eager / lazy : 0.0);
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief 노드 순서와 메모리 순서가 무작위로 섞인 리스트를 만든다.
+ * 노드와 Contact 를 모두 할당한 뒤 섞인 순서로 연결하므로 순회할 때마다
+ * 메모리를 건너뛰며 읽게 됨 (오래 사용한 리스트를 흉내)
+ * @return 성공 시 리스트 포인터, 실패 시 NULL
+ */
+LinkedList *buildShuffledBenchList(int size) {
+  LinkedList *list = createLinkedList(printContact, freeContactData);
+  Node **nodes = (Node **)malloc(sizeof(Node *) * size);
+  if (list == NULL || nodes == NULL) {
+    freeList(&list);
+    free(nodes);
+    return NULL;
+  }
+  char name[20];
+  int built = 0;
+  for (; built < size; ++built) {
+    snprintf(name, sizeof(name), "c%d", built);
+    nodes[built] = (Node *)malloc(sizeof(Node));
+    Contact *contact = createContact(name, built);
+    if (nodes[built] == NULL || contact == NULL) {
+      free(nodes[built]);
+      freeContactData(contact);
+      break;
+    }
+    nodes[built]->data = contact;
+    nodes[built]->deleted = 0;
+    nodes[built]->createdVersion = list->version;
+    nodes[built]->deletedVersion = VERSION_NONE;
+  }
+  // 할당 순서를 섞어서 연결
+  unsigned int seed = 2024u;
+  for (int i = built - 1; i > 0; --i) {
+    int j = (int)(benchRandom(&seed) % (unsigned int)(i + 1));
+    Node *t = nodes[i];
+    nodes[i] = nodes[j];
+    nodes[j] = t;
+  }
+  for (int i = 0; i < built; ++i) {
+    nodes[i]->next = (i + 1 < built) ? nodes[i + 1] : NULL;
+  }
+  list->head = built > 0 ? nodes[0] : NULL;
+  list->nodeCount = built;
+  free(nodes);
+  if (built < size) {
+    freeList(&list);
+    return NULL;
+  }
+  return list;
+}
+
+/**
+ * @brief 모든 Contact 의 횟수를 더함 (출력 없이 printList 와 같은 메모리를 읽음)
+ */
+long sumContactCounts(const LinkedList *list) {
+  long sum = 0;
+  for (Node *current = list->head; current != NULL; current = current->next) {
+    PREFETCH(current->next);
+    if (!current->deleted) {
+      sum += ((const Contact *)current->data)->count;
+    }
+  }
+  return sum;
+}
+
+/**
+ * @brief getListSize 와 sumContactCounts 를 repeat 번 반복한 시간(초)을 측정
+ * @param check 결과값 누적 (컴파일러가 순회를 없애지 못하게 함)
+ */
+double timeTraversal(const LinkedList *list, int repeat, long *check) {
+  clock_t start = clock();
+  for (int r = 0; r < repeat; ++r) {
+    *check += getListSize(list);
+    *check += sumContactCounts(list);
+  }
+  return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+int runDefragBenchmark(void) {
+  const int size = 500000;
+  const int repeat = 10;
+  long check = 0;
+
+  // 같은 모양의 리스트 두 개: 하나는 그대로, 하나는 재배치
+  LinkedList *scattered = buildShuffledBenchList(size);
+  LinkedList *packed = buildShuffledBenchList(size);
+  if (scattered == NULL || packed == NULL) {
+    fprintf(stderr, "오류: 벤치마크 메모리 할당 실패!\n");
+    freeList(&scattered);
+    freeList(&packed);
+    return 1;
+  }
+
+  printf("순회 벤치마크: 노드 %d 개가 섞인 리스트, 순회 %d 번 "
+         "(getListSize + 데이터 읽기)\n",
+         size, repeat);
+  double before = timeTraversal(packed, repeat, &check);
+
+  clock_t start = clock();
+  if (!defragmentList(packed, sizeof(Contact))) {
+    fprintf(stderr, "오류: 재배치 실패!\n");
+    freeList(&scattered);
+    freeList(&packed);
+    return 1;
+  }
+  double defragTime = (double)(clock() - start) / CLOCKS_PER_SEC;
+  double after = timeTraversal(packed, repeat, &check);
+
+  printf("  재배치 전 순회 : %9.3f ms\n", before * 1000.0);
+  printf("  재배치 소요    : %9.3f ms\n", defragTime * 1000.0);
+  printf("  재배치 후 순회 : %9.3f ms (%.2fx)\n", after * 1000.0,
+         after > 0 ? before / after : 0.0);
+
+  start = clock();
+  freeList(&scattered);
+  double freeBefore = (double)(clock() - start) / CLOCKS_PER_SEC;
+  start = clock();
+  freeList(&packed);
+  double freeAfter = (double)(clock() - start) / CLOCKS_PER_SEC;
+  printf("  freeList (재배치 전): %9.3f ms\n", freeBefore * 1000.0);
+  printf("  freeList (재배치 후): %9.3f ms\n", freeAfter * 1000.0);
+  printf("  (검증값 %ld)\n", check);
+  return 0;
+}
+
+// ----------------------------------------------------------------------------
+// 10. 입력 파이프라인 구현
+// ----------------------------------------------------------------------------
+
+/**
+ * @brief 입력 버퍼에서 한 줄을 읽어 개행 문자를 제거하고 line 에 저장.
+ * 줄이 size 보다 길면 나머지는 버림 (readLineSafe 와 같은 동작)
+ * @return 성공 시 1, 더 읽을 입력이 없으면 0
+ */
+int readInputLine(InputReader *reader, char *line, size_t size) {
+  size_t used = 0;
+  int gotAny = 0;
+  for (;;) {
+    if (reader->pos == reader->len) {
+      reader->len = fread(reader->buffer, 1, sizeof(reader->buffer), reader->fp);
+      reader->pos = 0;
+      if (reader->len == 0) {
+        break; // EOF
+      }
+    }
+    gotAny = 1;
+    // 버퍼 안에서 개행을 찾아 한 번에 복사
+    char *start = reader->buffer + reader->pos;
+    size_t avail = reader->len - reader->pos;
+    char *newline = (char *)memchr(start, '\n', avail);
+    size_t chunk = newline ? (size_t)(newline - start) : avail;
+    size_t copy = chunk < size - 1 - used ? chunk : size - 1 - used;
+    memcpy(line + used, start, copy);
+    used += copy;
+    reader->pos += chunk;
+    if (newline != NULL) {
+      reader->pos++; // 개행 문자 소비
+      break;
+    }
+  }
+  if (used > 0 && line[used - 1] == '\r') {
+    used--; // Windows 줄바꿈
+  }
+  line[used] = '\0';
+  return gotAny;
+}
+
+/**
+ * @brief 한 줄을 읽어 정수로 변환
+ * @return 성공 시 1, 입력 끝이면 0, 숫자가 아니면 -1
+ */
+int readInputInt(InputReader *reader, int *value) {
+  char line[32];
+  if (!readInputLine(reader, line, sizeof(line))) {
+    return 0;
+  }
+  char *end;
+  errno = 0;
+  long parsed = strtol(line, &end, 10);
+  while (*end == ' ' || *end == '\t') {
+    ++end; // 숫자 뒤의 공백은 허용
+  }
+  if (end == line || *end != '\0' || errno == ERANGE || parsed < INT_MIN ||
+      parsed > INT_MAX) {
+    return -1; // "3abc" 처럼 뒤에 다른 문자가 붙었거나 int 범위 밖
+  }
+  *value = (int)parsed;
+  return 1;
+}
+
+int parseCommand(InputReader *reader, Command *cmd) {
+  int result = readInputInt(reader, &cmd->op);
+  if (result <= 0) {
+    return result;
+  }
+  if (cmd->op == 0) {
+    return 0; // 0번 메뉴 = 입력 끝
+  }
+  cmd->name[0] = '\0';
+  cmd->count = 0;
+  cmd->position = 0;
+
+  // 메뉴 번호에 따라 이어지는 줄을 읽음 (대화형 입력과 같은 순서)
+  if (cmd->op >= 1 && cmd->op <= 3) {
+    if (!readInputLine(reader, cmd->name, sizeof(cmd->name))) {
+      return 0;
+    }
+  }
+  if (cmd->op == 1 || cmd->op == 2) {
+    result = readInputInt(reader, &cmd->count);
+    if (result <= 0) {
+      return result;
+    }
+  }
+  if (cmd->op == 2) {
+    result = readInputInt(reader, &cmd->position);
+    if (result <= 0) {
+      return result;
+    }
+  }
+  return (cmd->op >= 1 && cmd->op <= 6) ? 1 : -1;
+}
+
+int applyCommand(LinkedList **listPtr, Journal *journal, const Command *cmd) {
+  LinkedList *list = *listPtr;
+  Contact *contact;
+
+  switch (cmd->op) {
+  case 1: // 끝에 추가
+    contact = createContact(cmd->name, cmd->count);
+    if (contact == NULL) {
+      return 0;
+    }
+    if (!insertNodeAtEnd(list, contact)) {
+      freeContactData(contact);
+      return 0;
+    }
+    journalLog(journal, list, JOURNAL_INSERT_END, -1, contact->name,
+               contact->count);
+    return 1;
+
+  case 2: // 위치 지정 삽입
+    contact = createContact(cmd->name, cmd->count);
+    if (contact == NULL) {
+      return 0;
+    }
+    if (!insertNodeAtPosition(list, contact, cmd->position)) {
+      freeContactData(contact);
+      return 0;
+    }
+    journalLog(journal, list, JOURNAL_INSERT_AT, cmd->position, contact->name,
+               contact->count);
+    return 1;
+
+  case 3: // 이름으로 삭제
+    if (!deleteContactByName(list, cmd->name)) {
+      return 0;
+    }
+    journalLog(journal, list, JOURNAL_DELETE_NAME, -1, cmd->name, 0);
+    return 1;
+
+  case 4: { // 전체 목록 삭제 (지연 삭제 설정은 유지)
+    if (list->snapshots != NULL) {
+      // 열린 스냅샷이 노드를 지나고 있을 수 있으므로 해제하지 않고 tombstone 으로
+      if (!retireAllNodes(list)) {
+        return 0;
+      }
+      if (journal != NULL) {
+        compactJournal(journal, list);
+      }
+      return 1;
+    }
+    int lazy = list->lazyDelete;
+    double ratio = list->compactRatio;
+    freeList(listPtr);
+    *listPtr = createLinkedList(printContact, freeContactData);
+    if (*listPtr == NULL) {
+      return -1;
+    }
+    setLazyDelete(*listPtr, lazy, ratio);
+    if (journal != NULL) {
+      compactJournal(journal, *listPtr);
+    }
+    return 1;
+  }
+
+  case 5: // 지연 삭제 모드 전환
+    setLazyDelete(list, !list->lazyDelete, list->compactRatio);
+    return 1;
+
+  case 6: // 리스트 재배치
+    if (list->snapshots != NULL) {
+      fprintf(stderr, "재배치 불가: 스냅샷 사용 중에는 노드를 옮길 수 없습니다.\n");
+      return 0;
+    }
+    return defragmentList(list, sizeof(Contact));
+
+  default:
+    return 0;
+  }
+}
+
+void runSerial(InputReader *reader, LinkedList **listPtr, Journal *journal,
+               PipelineStats *stats) {
+  Command cmd;
+  int result;
+  while ((result = parseCommand(reader, &cmd)) != 0) {
+    if (result < 0) {
+      stats->invalid++;
+      continue;
+    }
+    stats->parsed++;
+    result = applyCommand(listPtr, journal, &cmd);
+    if (result < 0) {
+      return; // 리스트 재생성 실패
+    }
+    if (result) {
+      stats->applied++;
+    } else {
+      stats->failed++;
+    }
+  }
+}
+
+#ifdef HAVE_PIPELINE
+// reader(생산자) 하나, 변경 스레드(소비자) 하나만 쓰는 lock-free 링 버퍼.
+// head 는 생산자만, tail 은 소비자만 쓰므로 잠금 없이 acquire/release 로 충분.
+// 링이 오래 비거나 가득 차 있으면 기다리는 쪽은 조건 변수에서 잠들고, 상대는
+// 대기 플래그가 켜져 있을 때만 잠금을 잡고 깨움 (평소에는 잠금 없음)
+typedef struct CommandRing {
+  Command slots[RING_CAPACITY];
+  _Alignas(64) atomic_size_t head; // 다음에 쓸 위치 (생산자)
+  _Alignas(64) atomic_size_t tail; // 다음에 읽을 위치 (소비자)
+  atomic_int done;                 // 생산자가 입력을 모두 넣었으면 1
+  atomic_int consumerWaiting;      // 소비자가 notEmpty 에서 잠들었으면 1
+  atomic_int producerWaiting;      // 생산자가 notFull 에서 잠들었으면 1
+  mtx_t lock;                      // 잠들기/깨우기용 잠금
+  cnd_t notEmpty;                  // 명령이 들어왔거나 입력이 끝남
+  cnd_t notFull;                   // 소비자가 자리를 비움
+} CommandRing;
+
+// reader 스레드에 넘기는 인자
+typedef struct ReaderContext {
+  CommandRing *ring;
+  InputReader *reader;
+  long parsed;
+  long invalid;
+  long producerWaits;
+} ReaderContext;
+
+/**
+ * @brief 상대 스레드가 잠들어 있으면 깨움. 호출 전에 head/tail/done 을
+ * seq_cst 로 저장해야 잠들기 직전의 상대와 엇갈리지 않음
+ */
+void wakeRingWaiter(CommandRing *ring, atomic_int *waiting, cnd_t *cond) {
+  if (!atomic_load(waiting)) {
+    return;
+  }
+  mtx_lock(&ring->lock);
+  cnd_signal(cond);
+  mtx_unlock(&ring->lock);
+}
+
+/**
+ * @brief reader 스레드: 입력을 파싱해 링에 넣음. 링이 가득 차면 소비자가
+ * 자리를 비울 때까지 양보하다가 잠들어 기다림 (backpressure)
+ */
+int readerThreadMain(void *arg) {
+  ReaderContext *ctx = (ReaderContext *)arg;
+  CommandRing *ring = ctx->ring;
+  size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+  size_t tailCache = atomic_load_explicit(&ring->tail, memory_order_acquire);
+  Command cmd;
+  int result;
+
+  while ((result = parseCommand(ctx->reader, &cmd)) != 0) {
+    if (result < 0) {
+      ctx->invalid++;
+      continue;
+    }
+    // 가득 찼으면 소비자의 tail 을 다시 읽고, 그래도 가득이면 대기
+    int spins = 0;
+    while (head - tailCache == RING_CAPACITY) {
+      tailCache = atomic_load_explicit(&ring->tail, memory_order_acquire);
+      if (head - tailCache != RING_CAPACITY) {
+        break;
+      }
+      ctx->producerWaits++;
+      if (++spins < RING_SPIN_LIMIT) {
+        thrd_yield();
+        continue;
+      }
+      // 오래 가득 차 있으면 소비자가 깨울 때까지 잠듦
+      mtx_lock(&ring->lock);
+      atomic_store(&ring->producerWaiting, 1);
+      while (head - atomic_load(&ring->tail) == RING_CAPACITY) {
+        cnd_wait(&ring->notFull, &ring->lock);
+      }
+      atomic_store(&ring->producerWaiting, 0);
+      mtx_unlock(&ring->lock);
+      spins = 0;
+    }
+    ring->slots[head & (RING_CAPACITY - 1)] = cmd;
+    head++;
+    atomic_store(&ring->head, head); // seq_cst: 잠드는 소비자와 엇갈리지 않게
+    wakeRingWaiter(ring, &ring->consumerWaiting, &ring->notEmpty);
+    ctx->parsed++;
+  }
+  atomic_store(&ring->done, 1);
+  wakeRingWaiter(ring, &ring->consumerWaiting, &ring->notEmpty);
+  return 0;
+}
+
+/**
+ * @brief 링 버퍼의 잠금과 조건 변수를 정리하고 메모리를 해제
+ */
+void destroyRing(CommandRing *ring) {
+  cnd_destroy(&ring->notFull);
+  cnd_destroy(&ring->notEmpty);
+  mtx_destroy(&ring->lock);
+  free(ring);
+}
+#endif
+
+void runPipeline(InputReader *reader, LinkedList **listPtr, Journal *journal,
+                 PipelineStats *stats) {
+#ifdef HAVE_PIPELINE
+  CommandRing *ring = (CommandRing *)malloc(sizeof(CommandRing));
+  if (ring == NULL) {
+    fprintf(stderr, "경고: 링 버퍼 할당 실패, 직렬 모드로 처리합니다.\n");
+    runSerial(reader, listPtr, journal, stats);
+    return;
+  }
+  atomic_init(&ring->head, 0);
+  atomic_init(&ring->tail, 0);
+  atomic_init(&ring->done, 0);
+  atomic_init(&ring->consumerWaiting, 0);
+  atomic_init(&ring->producerWaiting, 0);
+  int lockReady = mtx_init(&ring->lock, mtx_plain) == thrd_success;
+  int emptyReady = lockReady && cnd_init(&ring->notEmpty) == thrd_success;
+  int fullReady = emptyReady && cnd_init(&ring->notFull) == thrd_success;
+  if (!fullReady) {
+    fprintf(stderr, "경고: 링 버퍼 동기화 준비 실패, 직렬 모드로 처리합니다.\n");
+    if (emptyReady) {
+      cnd_destroy(&ring->notEmpty);
+    }
+    if (lockReady) {
+      mtx_destroy(&ring->lock);
+    }
+    free(ring);
+    runSerial(reader, listPtr, journal, stats);
+    return;
+  }
+
+  ReaderContext ctx = {ring, reader, 0, 0, 0};
+  thrd_t readerThread;
+  if (thrd_create(&readerThread, readerThreadMain, &ctx) != thrd_success) {
+    fprintf(stderr, "경고: reader 스레드 생성 실패, 직렬 모드로 처리합니다.\n");
+    destroyRing(ring);
+    runSerial(reader, listPtr, journal, stats);
+    return;
+  }
+
+  // 변경 스레드(현재 스레드): 쌓인 명령을 최대 RING_DRAIN_BATCH 개씩 처리하고
+  // tail 은 묶음마다 한 번만 갱신
+  size_t tail = 0;
+  int fatal = 0;
+  int spins = 0;
+  for (;;) {
+    size_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    if (head == tail) {
+      if (atomic_load_explicit(&ring->done, memory_order_acquire) &&
+          atomic_load_explicit(&ring->head, memory_order_acquire) == tail) {
+        break; // 입력 끝, 남은 명령 없음
+      }
+      if (++spins < RING_SPIN_LIMIT) {
+        thrd_yield();
+        continue;
+      }
+      // 오래 비어 있으면 (터미널 입력 대기 등) reader 가 깨울 때까지 잠듦
+      mtx_lock(&ring->lock);
+      atomic_store(&ring->consumerWaiting, 1);
+      while (atomic_load(&ring->head) == tail && !atomic_load(&ring->done)) {
+        cnd_wait(&ring->notEmpty, &ring->lock);
+      }
+      atomic_store(&ring->consumerWaiting, 0);
+      mtx_unlock(&ring->lock);
+      spins = 0;
+      continue;
+    }
+    spins = 0;
+    size_t available = head - tail;
+    size_t batch = available < RING_DRAIN_BATCH ? available : RING_DRAIN_BATCH;
+    for (size_t i = 0; i < batch; ++i) {
+      const Command *cmd = &ring->slots[(tail + i) & (RING_CAPACITY - 1)];
+      int result = fatal ? 0 : applyCommand(listPtr, journal, cmd);
+      if (result < 0) {
+        fatal = 1; // 리스트 재생성 실패 - 남은 입력은 버림
+      } else if (result) {
+        stats->applied++;
+      } else {
+        stats->failed++;
+      }
+    }
+    tail += batch;
+    atomic_store(&ring->tail, tail); // seq_cst: 잠드는 생산자와 엇갈리지 않게
+    wakeRingWaiter(ring, &ring->producerWaiting, &ring->notFull);
+    stats->batches++;
+  }
+
+  thrd_join(readerThread, NULL);
+  stats->parsed += ctx.parsed;
+  stats->invalid += ctx.invalid;
+  stats->producerWaits += ctx.producerWaits;
+  destroyRing(ring);
+#else
+  runSerial(reader, listPtr, journal, stats);
+#endif
+}
+
+int runPipelineMode(void) {
+  LinkedList *friendList = createLinkedList(printContact, freeContactData);
+  InputReader *reader = (InputReader *)malloc(sizeof(InputReader));
+  if (friendList == NULL || reader == NULL) {
+    fprintf(stderr, "오류: 리스트 생성 실패!\n");
+    freeList(&friendList);
+    free(reader);
+    return 1;
+  }
+  Journal *journal = openJournal(JOURNAL_PATH, SNAPSHOT_PATH,
+                                 JOURNAL_GROUP_SIZE, JOURNAL_COMPACT_THRESHOLD);
+  if (journal == NULL) {
+    fprintf(stderr, "경고: 저널 생성 실패! 변경 내용이 저장되지 않습니다.\n");
+  }
+  loadFriendList(friendList, journal);
+
+  reader->fp = stdin;
+  reader->pos = 0;
+  reader->len = 0;
+  PipelineStats stats = {0, 0, 0, 0, 0, 0};
+  runPipeline(reader, &friendList, journal, &stats);
+
+  printList(friendList);
+  printf("명령 %ld 개 처리 (성공 %ld, 실패 %ld, 잘못된 입력 %ld), "
+         "묶음 %ld 번, reader 대기 %ld 번\n",
+         stats.parsed, stats.applied, stats.failed, stats.invalid,
+         stats.batches, stats.producerWaits);
+
+  int failed = friendList == NULL || stats.failed > 0 || stats.invalid > 0 ||
+               (journal != NULL && journal->failures > 0);
+  freeList(&friendList);
+  closeJournal(&journal);
+  free(reader);
+  return failed;
+}
+
+/**
+ * @brief 벽시계 시간(초) - 여러 스레드를 쓰므로 clock() 대신 사용
+ */
+double wallSeconds(void) {
+  struct timespec ts;
+  timespec_get(&ts, TIME_UTC);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief 메뉴 입력 형식의 명령 count 개를 파일에 씀. 위치 0~3 삽입과 가장 최근에
+ * 삽입한 이름의 삭제를 반씩 섞어서 리스트가 짧게 유지되도록 함 (파싱과 리스트
+ * 변경의 비용이 비슷한 경우). 리스트는 16 개를 넘지 않음
+ */
+void writeBenchCommands(FILE *fp, int count) {
+  int *live = (int *)malloc(sizeof(int) * count); // 삭제되지 않은 이름 스택
+  int liveCount = 0;
+  unsigned int seed = 777u;
+  for (int i = 0; i < count; ++i) {
+    int full = liveCount >= 16; // 리스트를 짧게 유지
+    if (live != NULL && liveCount > 0 && (full || (benchRandom(&seed) & 1))) {
+      fprintf(fp, "3\nn%d\n", live[--liveCount]);
+    } else {
+      int maxPosition = liveCount < 3 ? liveCount : 3;
+      int position = (int)(benchRandom(&seed) % (unsigned int)(maxPosition + 1));
+      fprintf(fp, "2\nn%d\n%d\n%d\n", i, i % 1000, position);
+      if (live != NULL) {
+        live[liveCount++] = i;
+      }
+    }
+  }
+  fprintf(fp, "0\n");
+  free(live);
+}
+
+int runPipelineBenchmark(void) {
+  const int count = 1000000;
+  FILE *fp = tmpfile();
+  InputReader *reader = (InputReader *)malloc(sizeof(InputReader));
+  if (fp == NULL || reader == NULL) {
+    fprintf(stderr, "오류: 벤치마크 준비 실패!\n");
+    if (fp != NULL) {
+      fclose(fp);
+    }
+    free(reader);
+    return 1;
+  }
+  writeBenchCommands(fp, count);
+
+  printf("입력 파이프라인 벤치마크: 명령 %d 개 (위치 삽입/이름 삭제 반반)\n",
+         count);
+  const char *modeNames[] = {"직렬 루프", "파이프라인"};
+  double elapsed[2] = {0.0, 0.0};
+  for (int mode = 0; mode < 2; ++mode) {
+    LinkedList *list = createLinkedList(printContact, freeContactData);
+    if (list == NULL) {
+      break;
+    }
+    rewind(fp);
+    reader->fp = fp;
+    reader->pos = 0;
+    reader->len = 0;
+    PipelineStats stats = {0, 0, 0, 0, 0, 0};
+
+    double start = wallSeconds();
+    if (mode == 0) {
+      runSerial(reader, &list, NULL, &stats);
+    } else {
+      runPipeline(reader, &list, NULL, &stats);
+    }
+    elapsed[mode] = wallSeconds() - start;
+
+    printf("  %-10s: %8.3f ms, %10.0f 명령/초 (성공 %ld, 실패 %ld",
+           modeNames[mode], elapsed[mode] * 1000.0,
+           elapsed[mode] > 0 ? stats.parsed / elapsed[mode] : 0.0,
+           stats.applied, stats.failed);
+    if (mode == 1) {
+      printf(", 묶음 %ld 번, reader 대기 %ld 번", stats.batches,
+             stats.producerWaits);
+    }
+    printf(")\n");
+    freeList(&list);
+  }
+  if (elapsed[1] > 0) {
+    printf("  파이프라인 / 직렬 처리량: %.2fx\n", elapsed[0] / elapsed[1]);
+  }
+  fclose(fp);
+  free(reader);
+  return 0;
+}
+
+// ----------------------------------------------------------------------------
+// 11. 스냅샷 (버전 노드 + epoch 기반 해제) 구현
+// ----------------------------------------------------------------------------
+//  - writer 는 변경할 때마다 list->version 을 1씩 올린다. 노드는 추가된
+//    버전(createdVersion)과 삭제된 버전(deletedVersion)을 가지고, 버전 v 의
+//    스냅샷은 createdVersion <= v < deletedVersion 인 노드만 본다.
+//  - 삭제는 표시만 하므로 스냅샷이 지나가는 노드는 그대로 남아 있고, 새 노드는
+//    내용을 다 채운 뒤에 연결하므로 reader 는 잠금 없이 순회할 수 있다.
+//  - compactTombstones 는 가장 오래된 스냅샷보다 먼저 삭제된 노드만 연결을
+//    끊고, 끊은 노드는 그 시점에 열려 있던 스냅샷이 모두 닫힌 뒤에 해제한다.
+
+int enableSnapshots(LinkedList *list) {
+  if (list == NULL) {
+    return 0;
+  }
+  if (list->snapshots != NULL) {
+    return 1;
+  }
+  // 이전 tombstone 은 삭제 버전 기록이 없으므로 켜기 전에 정리
+  compactTombstones(list);
+  SnapshotRegistry *registry =
+      (SnapshotRegistry *)calloc(1, sizeof(SnapshotRegistry));
+  if (registry == NULL) {
+    fprintf(stderr, "Error: Failed to allocate memory for snapshots.\n");
+    return 0;
+  }
+  list->snapshots = registry;
+  return 1;
+}
+
+int acquireSnapshot(const LinkedList *list, ListSnapshot *snapshot) {
+  if (list == NULL || list->snapshots == NULL) {
+    return 0;
+  }
+  SnapshotRegistry *registry = list->snapshots;
+  unsigned long version = LOAD_SHARED(&list->version);
+  for (int slot = 0; slot < MAX_SNAPSHOT_READERS; ++slot) {
+    unsigned long *reader = &registry->readers[slot];
+#if defined(__GNUC__) || defined(__clang__)
+    unsigned long empty = 0;
+    if (!__atomic_compare_exchange_n(reader, &empty, version, 0,
+                                     __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+      continue;
+    }
+#else
+    if (*reader != 0) {
+      continue;
+    }
+    *reader = version;
+#endif
+    // 칸에 버전을 적는 사이 writer 가 그 버전의 노드를 끊었을 수 있으므로,
+    // 적은 뒤에도 버전이 그대로인지 확인하고 바뀌었으면 새 버전으로 다시 적음
+    for (;;) {
+      FULL_FENCE();
+      unsigned long current = LOAD_SHARED(&list->version);
+      if (current == version) {
+        break;
+      }
+      version = current;
+      STORE_SHARED(reader, version);
+    }
+    snapshot->list = list;
+    snapshot->version = version;
+    snapshot->slot = slot;
+    return 1;
+  }
+  return 0; // 빈 칸 없음
+}
+
+void releaseSnapshot(ListSnapshot *snapshot) {
+  if (snapshot == NULL || snapshot->list == NULL) {
+    return;
+  }
+  STORE_SHARED(&snapshot->list->snapshots->readers[snapshot->slot], 0UL);
+  snapshot->list = NULL;
+}
+
+/**
+ * @brief node 부터 시작해서 스냅샷 버전에서 보이는 첫 노드를 찾음
+ */
+Node *skipInvisible(const ListSnapshot *snapshot, Node *node) {
+  while (node != NULL &&
+         (node->createdVersion > snapshot->version ||
+          LOAD_SHARED(&node->deletedVersion) <= snapshot->version)) {
+    node = LOAD_SHARED(&node->next);
+  }
+  return node;
+}
+
+Node *snapshotFirst(const ListSnapshot *snapshot) {
+  return skipInvisible(snapshot, LOAD_SHARED(&snapshot->list->head));
+}
+
+Node *snapshotNext(const ListSnapshot *snapshot, const Node *node) {
+  return skipInvisible(snapshot, LOAD_SHARED(&node->next));
+}
+
+int getSnapshotSize(const ListSnapshot *snapshot) {
+  int count = 0;
+  for (Node *node = snapshotFirst(snapshot); node != NULL;
+       node = snapshotNext(snapshot, node)) {
+    count++;
+  }
+  return count;
+}
+
+int retireAllNodes(LinkedList *list) {
+  SnapshotRegistry *registry = list->snapshots;
+  size_t needed = (size_t)list->nodeCount; // 모두 tombstone 이 된 뒤의 기록 수
+  if (needed > registry->tombstoneCapacity) {
+    // 표시를 시작하기 전에 기록 공간을 모두 확보 (도중에 실패하지 않도록)
+    unsigned long *versions = (unsigned long *)realloc(
+        registry->tombstoneVersions, sizeof(unsigned long) * needed);
+    if (versions == NULL) {
+      fprintf(stderr, "Error: Failed to allocate memory for tombstones.\n");
+      return 0;
+    }
+    registry->tombstoneVersions = versions;
+    registry->tombstoneCapacity = needed;
+  }
+  // 기존 tombstone 의 버전은 모두 이보다 작으므로 기록은 오름차순을 유지
+  unsigned long version = list->version + 1;
+  for (Node *node = list->head; node != NULL; node = node->next) {
+    if (!node->deleted) {
+      registry->tombstoneVersions[list->tombstoneCount++] = version;
+      node->deleted = 1;
+      STORE_SHARED(&node->deletedVersion, version);
+    }
+  }
+  STORE_SHARED(&list->version, version);
+  compactTombstones(list); // 열린 스냅샷이 없으면 바로 끊고, 있으면 나중에
+  reclaimRetired(list);
+  return 1;
+}
+
+unsigned long oldestSnapshotVersion(const LinkedList *list) {
+  unsigned long oldest = VERSION_NONE;
+  if (list->snapshots == NULL) {
+    return oldest;
+  }
+  // 앞서 올린 버전이 reader 에게 보인 뒤에 칸을 읽도록 (acquireSnapshot 참고)
+  FULL_FENCE();
+  for (int slot = 0; slot < MAX_SNAPSHOT_READERS; ++slot) {
+    unsigned long version = LOAD_SHARED(&list->snapshots->readers[slot]);
+    if (version != 0 && version < oldest) {
+      oldest = version;
+    }
+  }
+  return oldest;
+}
+
+int reserveRetired(SnapshotRegistry *registry, size_t extra) {
+  size_t needed = registry->retiredCount + extra;
+  if (needed <= registry->retiredCapacity) {
+    return 1;
+  }
+  size_t capacity = registry->retiredCapacity ? registry->retiredCapacity : 64;
+  while (capacity < needed) {
+    capacity *= 2;
+  }
+  RetiredNode *retired =
+      (RetiredNode *)realloc(registry->retired, sizeof(RetiredNode) * capacity);
+  if (retired == NULL) {
+    fprintf(stderr, "Error: Failed to allocate memory for retired nodes.\n");
+    return 0;
+  }
+  registry->retired = retired;
+  registry->retiredCapacity = capacity;
+  return 1;
+}
+
+int recordTombstone(LinkedList *list, unsigned long version) {
+  SnapshotRegistry *registry = list->snapshots;
+  size_t needed = (size_t)list->tombstoneCount + 1;
+  if (needed > registry->tombstoneCapacity) {
+    size_t capacity =
+        registry->tombstoneCapacity ? registry->tombstoneCapacity * 2 : 64;
+    unsigned long *versions = (unsigned long *)realloc(
+        registry->tombstoneVersions, sizeof(unsigned long) * capacity);
+    if (versions == NULL) {
+      fprintf(stderr, "Error: Failed to allocate memory for tombstones.\n");
+      return 0;
+    }
+    registry->tombstoneVersions = versions;
+    registry->tombstoneCapacity = capacity;
+  }
+  registry->tombstoneVersions[list->tombstoneCount] = version;
+  return 1;
+}
+
+int reclaimableTombstones(const LinkedList *list) {
+  if (list->snapshots == NULL) {
+    return list->tombstoneCount;
+  }
+  // 기록은 오름차순이므로 oldest 이하인 앞부분의 길이를 이분 탐색
+  const unsigned long *versions = list->snapshots->tombstoneVersions;
+  unsigned long oldest = oldestSnapshotVersion(list);
+  int low = 0;
+  int high = list->tombstoneCount;
+  while (low < high) {
+    int mid = low + (high - low) / 2;
+    if (versions[mid] <= oldest) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+int reclaimRetired(LinkedList *list) {
+  if (list == NULL || list->snapshots == NULL ||
+      list->snapshots->retiredCount == 0) {
+    return 0;
+  }
+  SnapshotRegistry *registry = list->snapshots;
+  unsigned long oldest = oldestSnapshotVersion(list);
+  // retired 는 버전 오름차순이므로 앞에서부터 해제 가능한 만큼만 해제
+  size_t freed = 0;
+  while (freed < registry->retiredCount &&
+         registry->retired[freed].version <= oldest) {
+    releaseNode(list, registry->retired[freed].node);
+    freed++;
+  }
+  if (freed > 0) {
+    registry->retiredCount -= freed;
+    memmove(registry->retired, registry->retired + freed,
+            sizeof(RetiredNode) * registry->retiredCount);
+    registry->reclaimedTotal += (long)freed;
+  }
+  return (int)freed;
+}
+
+#define SNAPSHOT_DEMO_SIZE 1000      // 처음 리스트 크기
+#define SNAPSHOT_DEMO_OPS 50000      // writer 가 실행할 변경 수
+#define SNAPSHOT_DEMO_READERS 3      // reader 스레드 수
+
+#ifdef HAVE_PIPELINE
+// 데모의 writer 와 reader 스레드가 공유하는 상태
+typedef struct SnapshotDemo {
+  LinkedList *list;
+  long long *history;             // history[v] = 버전 v 의 count 합계
+  atomic_ulong recordedVersion;   // history 가 채워진 마지막 버전
+  atomic_int done;                // writer 가 끝났으면 1
+  atomic_long snapshots;          // reader 들이 확인한 스냅샷 수
+  atomic_long mismatches;         // 합계가 history 와 다른 스냅샷 수
+  atomic_long acquireFailures;    // 빈 칸이 없어 스냅샷을 못 연 횟수
+} SnapshotDemo;
+
+/**
+ * @brief reader 스레드: 스냅샷을 열어 합계를 구하고 writer 의 기록과 비교
+ */
+int snapshotReaderMain(void *arg) {
+  SnapshotDemo *demo = (SnapshotDemo *)arg;
+  ListSnapshot snapshot;
+  while (!atomic_load_explicit(&demo->done, memory_order_acquire)) {
+    if (!acquireSnapshot(demo->list, &snapshot)) {
+      atomic_fetch_add(&demo->acquireFailures, 1);
+      thrd_yield();
+      continue;
+    }
+    long long sum = 0;
+    for (Node *node = snapshotFirst(&snapshot); node != NULL;
+         node = snapshotNext(&snapshot, node)) {
+      sum += ((const Contact *)node->data)->count;
+    }
+    // writer 가 이 버전의 합계를 기록할 때까지 대기
+    while (atomic_load_explicit(&demo->recordedVersion, memory_order_acquire) <
+           snapshot.version) {
+      thrd_yield();
+    }
+    if (sum != demo->history[snapshot.version]) {
+      atomic_fetch_add(&demo->mismatches, 1);
+    }
+    releaseSnapshot(&snapshot);
+    atomic_fetch_add(&demo->snapshots, 1);
+  }
+  return 0;
+}
+#endif
+
+int runSnapshotDemo(void) {
+#ifndef HAVE_PIPELINE
+  printf("C11 스레드가 없어 스냅샷 데모를 실행할 수 없습니다.\n");
+  return 1;
+#else
+  printf("스냅샷 데모: 리스트 %d 개, 변경 %d 번, reader 스레드 %d 개\n",
+         SNAPSHOT_DEMO_SIZE, SNAPSHOT_DEMO_OPS, SNAPSHOT_DEMO_READERS);
+
+  // 삽입/삭제 한 번에 버전은 최대 2 (삭제 + 정리) 증가
+  size_t historySize = (size_t)SNAPSHOT_DEMO_SIZE + 2 * SNAPSHOT_DEMO_OPS + 2;
+  SnapshotDemo *demo = (SnapshotDemo *)malloc(sizeof(SnapshotDemo));
+  long long *history = (long long *)malloc(sizeof(long long) * historySize);
+  int *liveIds = (int *)malloc(sizeof(int) * (SNAPSHOT_DEMO_SIZE +
+                                              SNAPSHOT_DEMO_OPS));
+  LinkedList *list = createLinkedList(printContact, freeContactData);
+  if (demo == NULL || history == NULL || liveIds == NULL || list == NULL ||
+      !enableSnapshots(list)) {
+    fprintf(stderr, "오류: 데모 메모리 할당 실패!\n");
+    free(demo);
+    free(history);
+    free(liveIds);
+    freeList(&list);
+    return 1;
+  }
+  setLazyDelete(list, 1, TOMBSTONE_COMPACT_RATIO);
+
+  // 초기 데이터: 버전마다 합계를 기록
+  char name[20];
+  int liveCount = 0;
+  int nextId = 0;
+  long long sum = 0;
+  history[list->version] = 0;
+  Node *tail = NULL;
+  for (; nextId < SNAPSHOT_DEMO_SIZE; ++nextId) {
+    snprintf(name, sizeof(name), "c%d", nextId);
+    Contact *contact = createContact(name, nextId % 97);
+    tail = contact ? appendNodeAfter(list, tail, contact) : NULL;
+    if (tail == NULL) {
+      freeContactData(contact);
+      break;
+    }
+    liveIds[liveCount++] = nextId;
+    sum += contact->count;
+    history[list->version] = sum;
+  }
+
+  demo->list = list;
+  demo->history = history;
+  atomic_init(&demo->recordedVersion, list->version);
+  atomic_init(&demo->done, 0);
+  atomic_init(&demo->snapshots, 0);
+  atomic_init(&demo->mismatches, 0);
+  atomic_init(&demo->acquireFailures, 0);
+
+  thrd_t readers[SNAPSHOT_DEMO_READERS];
+  int started = 0;
+  for (; started < SNAPSHOT_DEMO_READERS; ++started) {
+    if (thrd_create(&readers[started], snapshotReaderMain, demo) !=
+        thrd_success) {
+      fprintf(stderr, "오류: reader 스레드 생성 실패!\n");
+      break;
+    }
+  }
+
+  // writer: 끝에 추가, 위치 삽입, 이름으로 삭제를 무작위로 실행
+  unsigned int seed = 7u;
+  double start = wallSeconds();
+  for (int op = 0; op < SNAPSHOT_DEMO_OPS; ++op) {
+    unsigned long before = list->version;
+    unsigned int choice = benchRandom(&seed) % 4; // 추가와 삭제를 반반씩
+    if (choice >= 2 && liveCount > 0) {
+      int index = (int)(benchRandom(&seed) % (unsigned int)liveCount);
+      snprintf(name, sizeof(name), "c%d", liveIds[index]);
+      Node *node = list->head;
+      while (node != NULL &&
+             (node->deleted ||
+              strcmp(((const Contact *)node->data)->name, name) != 0)) {
+        node = node->next;
+      }
+      if (node != NULL) {
+        sum -= ((const Contact *)node->data)->count;
+      }
+      if (deleteContactByName(list, name)) {
+        liveIds[index] = liveIds[--liveCount];
+      }
+    } else {
+      snprintf(name, sizeof(name), "c%d", nextId);
+      Contact *contact = createContact(name, (int)(benchRandom(&seed) % 97));
+      if (contact == NULL) {
+        break;
+      }
+      int inserted;
+      if (choice == 0) {
+        inserted = insertNodeAtEnd(list, contact);
+      } else {
+        inserted = insertNodeAtPosition(
+            list, contact,
+            (int)(benchRandom(&seed) % (unsigned int)(liveCount + 1)));
+      }
+      if (!inserted) {
+        freeContactData(contact);
+        continue;
+      }
+      liveIds[liveCount++] = nextId++;
+      sum += contact->count;
+    }
+    // 이번 변경으로 생긴 버전들 (정리로 올라간 버전은 내용이 같음)
+    for (unsigned long v = before + 1; v <= list->version; ++v) {
+      history[v] = sum;
+    }
+    atomic_store_explicit(&demo->recordedVersion, list->version,
+                          memory_order_release);
+  }
+  double elapsed = wallSeconds() - start;
+
+  atomic_store_explicit(&demo->done, 1, memory_order_release);
+  for (int i = 0; i < started; ++i) {
+    thrd_join(readers[i], NULL);
+  }
+  SnapshotRegistry *registry = list->snapshots;
+  size_t pendingBefore = registry->retiredCount;
+  compactTombstones(list); // reader 가 모두 끝났으므로 남은 것도 정리
+  reclaimRetired(list);
+
+  long mismatches = atomic_load(&demo->mismatches);
+  printf("  writer     : %8.3f ms, 버전 %lu 까지 진행\n", elapsed * 1000.0,
+         list->version);
+  printf("  스냅샷     : %ld 개 확인, 불일치 %ld 개, 빈 칸 없음 %ld 번\n",
+         atomic_load(&demo->snapshots), mismatches,
+         atomic_load(&demo->acquireFailures));
+  printf("  해제 지연  : %ld 개 노드, 해제 완료 %ld 개 (reader 종료 시 대기 "
+         "%zu 개, 정리 후 %zu 개)\n",
+         registry->retiredTotal, registry->reclaimedTotal, pendingBefore,
+         registry->retiredCount);
+  printf("  최종 리스트: %d 개 (예상 %d 개)\n", getListSize(list), liveCount);
+
+  int failed = mismatches != 0 || getListSize(list) != liveCount;
+  freeList(&list);
+  free(liveIds);
+  free(history);
+  free(demo);
+  return failed;
+#endif
+}
+
+// ----------------------------------------------------------------------------
+// 12. 소켓 서버 (Unix 도메인 소켓 + epoll) 구현
+// ----------------------------------------------------------------------------
+//  - 스레드 하나가 epoll(level-triggered) 로 모든 연결을 처리한다.
+//  - 읽기 한 번에 들어온 요청을 모두 처리하고, 그 응답을 연결의 출력 버퍼에
+//    모아 write 한 번으로 보낸다. 다 못 보내면 EPOLLOUT 을 기다린다.
+//  - 변경 요청은 저널 버퍼에 쌓아 두었다가 응답을 보내기 전에 묶음마다 한 번
+//    fsync 하므로, 클라이언트가 성공 응답을 받은 변경은 디스크에 있다.
+
+#ifdef HAVE_SERVER
+// 연결 하나의 상태 (epoll 이벤트의 data.ptr)
+typedef struct Connection {
+  int fd;
+  unsigned char in[SERVER_READ_BUFFER]; // 아직 처리하지 않은 요청 바이트
+  size_t inLen;
+  unsigned char *out;  // 보낼 응답 (한 묶음의 응답을 모아 둠)
+  size_t outLen;       // out 에 쌓인 바이트 수
+  size_t outSent;      // 그중 이미 보낸 바이트 수
+  size_t outCapacity;  // out 배열 크기
+  unsigned int events; // 현재 epoll 에 등록한 이벤트
+  struct Connection *prev; // 열린 연결 목록 (종료 시 정리용)
+  struct Connection *next;
+} Connection;
+
+// 서버 전체 상태
+typedef struct Server {
+  int epollFd;
+  int listenFd;
+  LinkedList *list;
+  Journal *journal;
+  Connection *connections; // 열린 연결 목록의 맨 앞
+  ServerStats stats;
+} Server;
+
+volatile sig_atomic_t serverStopping = 0; // SIGINT/SIGTERM 을 받으면 1
+
+void onServerSignal(int signum) {
+  (void)signum;
+  serverStopping = 1;
+}
+
+// --- 호스트 바이트 순서 정수 읽기/쓰기 (정렬되지 않은 위치도 안전하게) ---
+int32_t getInt32(const unsigned char *p) {
+  int32_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+void putInt32(unsigned char *p, int32_t value) {
+  memcpy(p, &value, sizeof(value));
+}
+
+void putInt64(unsigned char *p, long long value) {
+  int64_t v = (int64_t)value;
+  memcpy(p, &v, sizeof(v));
+}
+
+/**
+ * @brief 출력 버퍼에 extra 바이트를 더 쓸 수 있도록 크기를 늘림.
+ * 이미 보낸 앞부분은 이때 버림
+ * @return 성공 시 1, 실패(메모리 부족) 시 0
+ */
+int reserveOutput(Connection *conn, size_t extra) {
+  if (conn->outSent > 0) {
+    memmove(conn->out, conn->out + conn->outSent, conn->outLen - conn->outSent);
+    conn->outLen -= conn->outSent;
+    conn->outSent = 0;
+  }
+  size_t needed = conn->outLen + extra;
+  if (needed <= conn->outCapacity) {
+    return 1;
+  }
+  size_t capacity = conn->outCapacity ? conn->outCapacity : 4096;
+  while (capacity < needed) {
+    capacity *= 2;
+  }
+  unsigned char *out = (unsigned char *)realloc(conn->out, capacity);
+  if (out == NULL) {
+    return 0;
+  }
+  conn->out = out;
+  conn->outCapacity = capacity;
+  return 1;
+}
+
+/**
+ * @brief 출력 버퍼 끝에 응답 헤더를 쓰고 본문을 쓸 위치를 반환
+ * @param conn 대상 연결
+ * @param status 응답 상태
+ * @param bodyLength 본문 길이 (reserve 도 이만큼 함)
+ * @return 본문을 쓸 위치, 메모리 부족 시 NULL
+ */
+unsigned char *beginResponse(Connection *conn, ServerStatus status,
+                             size_t bodyLength) {
+  if (!reserveOutput(conn, 5 + bodyLength)) {
+    return NULL;
+  }
+  unsigned char *frame = conn->out + conn->outLen;
+  uint32_t length = (uint32_t)(1 + bodyLength);
+  memcpy(frame, &length, sizeof(length));
+  frame[4] = (unsigned char)status;
+  conn->outLen += 5 + bodyLength;
+  return frame + 5;
+}
+
+/**
+ * @brief 요청 본문 끝의 이름을 검사해 NUL 종단 문자열로 복사
+ * @return 올바른 이름(1~19 바이트, NUL 없음)이면 1, 아니면 0
+ */
+int copyRequestName(char *dest, const unsigned char *src, size_t length) {
+  if (length < 1 || length > 19 || memchr(src, '\0', length) != NULL) {
+    return 0;
+  }
+  memcpy(dest, src, length);
+  dest[length] = '\0';
+  return 1;
+}
+
+/**
+ * @brief 요청 하나를 처리하고 응답을 출력 버퍼에 추가
+ * @param server 서버 상태
+ * @param conn 요청을 보낸 연결
+ * @param frame 길이 필드 뒤의 요청 바이트 ([u8 op][본문])
+ * @param length frame 의 길이 (1 이상)
+ * @return 성공 시 1, 메모리 부족 시 0 (연결을 닫음)
+ */
+int handleRequest(Server *server, Connection *conn, const unsigned char *frame,
+                  size_t length) {
+  const unsigned char *body = frame + 1;
+  size_t bodyLength = length - 1;
+  LinkedList *list = server->list;
+  Command cmd = {0, "", 0, 0};
+  cmd.op = frame[0];
+  server->stats.requests++;
+
+  switch (cmd.op) {
+  case SERVER_OP_APPEND:
+  case SERVER_OP_INSERT:
+  case SERVER_OP_DELETE: {
+    // 이름 앞의 정수 필드: 추가는 count, 삽입은 position + count
+    size_t fixed = cmd.op == SERVER_OP_APPEND   ? 4
+                   : cmd.op == SERVER_OP_INSERT ? 8
+                                                : 0;
+    if (bodyLength < fixed ||
+        !copyRequestName(cmd.name, body + fixed, bodyLength - fixed)) {
+      break; // 잘못된 요청
+    }
+    if (cmd.op == SERVER_OP_APPEND) {
+      cmd.count = getInt32(body);
+    } else if (cmd.op == SERVER_OP_INSERT) {
+      cmd.position = getInt32(body);
+      cmd.count = getInt32(body + 4);
+    }
+    int result = applyCommand(&server->list, server->journal, &cmd);
+    return beginResponse(conn, result > 0 ? SERVER_OK : SERVER_FAILED, 0) !=
+           NULL;
+  }
+
+  case SERVER_OP_SIZE: {
+    if (bodyLength != 0) {
+      break;
+    }
+    unsigned char *out = beginResponse(conn, SERVER_OK, 4);
+    if (out == NULL) {
+      return 0;
+    }
+    putInt32(out, list->nodeCount - list->tombstoneCount);
+    return 1;
+  }
+
+  case SERVER_OP_DUMP: {
+    if (bodyLength != 0) {
+      break;
+    }
+    // 한 버전의 스냅샷으로 읽으므로 tombstone 과 정리 대기 노드는 보이지 않음
+    ListSnapshot snapshot;
+    if (!acquireSnapshot(list, &snapshot)) {
+      return beginResponse(conn, SERVER_FAILED, 0) != NULL;
+    }
+    // 최대 크기로 잡아 두고 실제로 쓴 만큼으로 길이를 고침
+    int live = getSnapshotSize(&snapshot);
+    size_t start = conn->outLen - conn->outSent; // reserve 후의 프레임 위치
+    unsigned char *out =
+        beginResponse(conn, SERVER_OK, 4 + (size_t)live * (4 + 1 + 19));
+    if (out == NULL) {
+      releaseSnapshot(&snapshot);
+      return 0;
+    }
+    unsigned char *p = out + 4;
+    for (Node *node = snapshotFirst(&snapshot); node != NULL;
+         node = snapshotNext(&snapshot, node)) {
+      PREFETCH(node->next);
+      const Contact *contact = (const Contact *)node->data;
+      size_t nameLength = strlen(contact->name);
+      putInt32(p, contact->count);
+      p[4] = (unsigned char)nameLength;
+      memcpy(p + 5, contact->name, nameLength);
+      p += 5 + nameLength;
+    }
+    releaseSnapshot(&snapshot);
+    putInt32(out, live);
+    uint32_t frameLength = (uint32_t)(1 + (p - out));
+    memcpy(conn->out + start, &frameLength, sizeof(frameLength));
+    conn->outLen = (size_t)(p - conn->out);
+    return 1;
+  }
+
+  case SERVER_OP_STATS: {
+    if (bodyLength != 0) {
+      break;
+    }
+    unsigned char *out = beginResponse(conn, SERVER_OK, 8 * 8);
+    if (out == NULL) {
+      return 0;
+    }
+    ServerStats *stats = &server->stats;
+    stats->listSize = list->nodeCount - list->tombstoneCount;
+    const long long values[8] = {stats->connections, stats->requests,
+                                 stats->badRequests, stats->readBatches,
+                                 stats->writeCalls,  stats->bytesIn,
+                                 stats->bytesOut,    stats->listSize};
+    for (int i = 0; i < 8; ++i) {
+      putInt64(out + 8 * i, values[i]);
+    }
+    return 1;
+  }
+
+  default:
+    break;
+  }
+  server->stats.badRequests++;
+  return beginResponse(conn, SERVER_BAD_REQUEST, 0) != NULL;
+}
+
+/**
+ * @brief 입력 버퍼에 완전히 들어온 요청 프레임을 모두 처리하고, 남은 조각은
+ * 버퍼 앞으로 옮김
+ * @return 성공 시 1, 프레임 길이가 잘못되었거나 메모리 부족 시 0 (연결을 닫음)
+ */
+int processRequests(Server *server, Connection *conn) {
+  size_t pos = 0;
+  while (conn->inLen - pos >= 4) {
+    uint32_t length;
+    memcpy(&length, conn->in + pos, sizeof(length));
+    if (length < 1 || length > SERVER_MAX_FRAME) {
+      server->stats.badRequests++;
+      return 0; // 프레임 경계를 잃었으므로 더 읽을 수 없음
+    }
+    if (conn->inLen - pos - 4 < length) {
+      break; // 아직 다 오지 않은 프레임
+    }
+    if (!handleRequest(server, conn, conn->in + pos + 4, length)) {
+      return 0;
+    }
+    pos += 4 + length;
+  }
+  memmove(conn->in, conn->in + pos, conn->inLen - pos);
+  conn->inLen -= pos;
+  return 1;
+}
+
+/**
+ * @brief 출력 버퍼에 남은 응답을 write 한 번으로 보냄
+ * @return 성공(일부만 보낸 경우 포함) 시 1, 연결 오류 시 0
+ */
+int flushOutput(Server *server, Connection *conn) {
+  if (conn->outSent == conn->outLen) {
+    return 1;
+  }
+  ssize_t n = send(conn->fd, conn->out + conn->outSent,
+                   conn->outLen - conn->outSent, MSG_NOSIGNAL);
+  if (n < 0) {
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+  }
+  server->stats.writeCalls++;
+  server->stats.bytesOut += n;
+  conn->outSent += (size_t)n;
+  if (conn->outSent == conn->outLen) {
+    conn->outSent = 0;
+    conn->outLen = 0;
+  }
+  return 1;
+}
+
+/**
+ * @brief 보낼 응답이 남았으면 EPOLLOUT 을 기다리고, 너무 많이 남았으면 읽기를
+ * 멈춤 (느린 클라이언트에 대한 backpressure)
+ */
+void updateInterest(Server *server, Connection *conn) {
+  size_t pending = conn->outLen - conn->outSent;
+  unsigned int events = EPOLLIN;
+  if (pending > 0) {
+    events = pending > SERVER_WRITE_LIMIT ? EPOLLOUT : (EPOLLIN | EPOLLOUT);
+  }
+  if (events != conn->events) {
+    struct epoll_event ev;
+    ev.events = events;
+    ev.data.ptr = conn;
+    epoll_ctl(server->epollFd, EPOLL_CTL_MOD, conn->fd, &ev);
+    conn->events = events;
+  }
+}
+
+void closeConnection(Server *server, Connection *conn) {
+  epoll_ctl(server->epollFd, EPOLL_CTL_DEL, conn->fd, NULL);
+  close(conn->fd);
+  if (conn->prev != NULL) {
+    conn->prev->next = conn->next;
+  } else {
+    server->connections = conn->next;
+  }
+  if (conn->next != NULL) {
+    conn->next->prev = conn->prev;
+  }
+  free(conn->out);
+  free(conn);
+}
+
+/**
+ * @brief 대기 중인 연결을 모두 받아들여 epoll 에 등록
+ */
+void acceptConnections(Server *server) {
+  for (;;) {
+    int fd = accept(server->listenFd, NULL, NULL);
+    if (fd < 0) {
+      if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+        perror("accept 실패");
+      }
+      return;
+    }
+    Connection *conn = (Connection *)calloc(1, sizeof(Connection));
+    if (conn == NULL || fcntl(fd, F_SETFL, O_NONBLOCK) < 0) {
+      fprintf(stderr, "오류: 연결 준비 실패!\n");
+      free(conn);
+      close(fd);
+      continue;
+    }
+    conn->fd = fd;
+    conn->events = EPOLLIN;
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.ptr = conn;
+    if (epoll_ctl(server->epollFd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+      perror("epoll 등록 실패");
+      free(conn);
+      close(fd);
+      continue;
+    }
+    conn->next = server->connections;
+    if (server->connections != NULL) {
+      server->connections->prev = conn;
+    }
+    server->connections = conn;
+    server->stats.connections++;
+  }
+}
+
+/**
+ * @brief 묶음에서 성공으로 응답한 변경 요청 중 앞의 keep 개를 뺀 나머지를 모두
+ * SERVER_FAILED 로 바꿈. 본문 없는 SERVER_OK 응답은 변경 요청의 응답뿐이므로
+ * 응답 프레임만 보고 찾을 수 있고, 순서는 journalLog 에 기록된 순서와 같음
+ * @param conn 대상 연결
+ * @param batchStart 묶음 처리 전의 보내지 않은 응답 바이트 수
+ * @param keep 디스크에 남아 성공 응답을 유지할 변경 요청 수
+ */
+void failBatchResponses(Connection *conn, size_t batchStart, long keep) {
+  // reserveOutput 이 보낸 앞부분을 버려도 outSent 기준 위치는 그대로
+  size_t pos = conn->outSent + batchStart;
+  while (pos < conn->outLen) {
+    uint32_t length;
+    memcpy(&length, conn->out + pos, sizeof(length));
+    if (length == 1 && conn->out[pos + 4] == SERVER_OK && keep-- <= 0) {
+      conn->out[pos + 4] = SERVER_FAILED;
+    }
+    pos += 4 + length;
+  }
+}
+
+/**
+ * @brief 스냅샷과 저널을 다시 읽은 새 리스트로 서버 리스트를 바꿈. 디스크에
+ * 남지 못한 변경을 메모리에서도 되돌리는 데 사용
+ * @return 성공 시 1, 실패(메모리 부족) 시 0 - 실패하면 리스트는 그대로
+ */
+int reloadServerList(Server *server) {
+  Journal *journal = server->journal;
+  LinkedList *list = createLinkedList(printContact, freeContactData);
+  if (list == NULL) {
+    return 0;
+  }
+  // replayJournal 이 저널을 다시 열고 레코드 수를 새로 셈
+  if (journal->fp != NULL) {
+    fclose(journal->fp);
+    journal->fp = NULL;
+  }
+  journal->pendingCount = 0;
+  journal->recordCount = 0;
+  journal->diverged = 0;
+  replayJournal(journal, list);
+  if (!enableSnapshots(list)) {
+    freeList(&list);
+    journal->diverged = 1; // 메모리가 디스크보다 앞서 있음
+    return 0;
+  }
+  setLazyDelete(list, server->list->lazyDelete, server->list->compactRatio);
+  freeList(&server->list);
+  server->list = list;
+  journal->durable = journal->logged; // 메모리와 디스크가 같아짐
+  return 1;
+}
+
+/**
+ * @brief 묶음의 저널 기록이 실패했을 때 응답, 메모리, 디스크를 다시 맞춤.
+ * 지금 리스트를 스냅샷으로 저장할 수 있으면 디스크가 메모리를 따라잡으므로
+ * 응답은 그대로 두고, 그것도 실패하면 리스트를 디스크 내용으로 되돌린 뒤
+ * 디스크에 남지 못한 변경 요청의 응답을 SERVER_FAILED 로 바꿈
+ * @param conn 대상 연결
+ * @param batchStart 묶음 처리 전의 보내지 않은 응답 바이트 수
+ * @param loggedBefore 묶음 처리 전의 journal->logged
+ */
+void recoverFailedBatch(Server *server, Connection *conn, size_t batchStart,
+                        long loggedBefore) {
+  Journal *journal = server->journal;
+  if (compactJournal(journal, server->list)) {
+    return;
+  }
+  long kept = journal->durable - loggedBefore; // 묶음 중 디스크에 남은 변경 수
+  if (!reloadServerList(server)) {
+    // 되돌릴 수 없으면 디스크에 없는 변경이 다음 압축에 섞이지 않도록 종료
+    fprintf(stderr, "오류: 리스트를 디스크 내용으로 되돌리지 못해 서버를 "
+                    "종료합니다.\n");
+    serverStopping = 1;
+  }
+  failBatchResponses(conn, batchStart, kept);
+}
+
+/**
+ * @brief 읽을 수 있는 연결에서 한 번 읽고, 그 묶음의 요청을 처리한 뒤 저널을
+ * commit 하고 응답을 한 번에 보냄. commit 이 실패하면 recoverFailedBatch 로
+ * 응답, 메모리, 디스크를 맞춘 뒤 보냄
+ */
+void handleReadable(Server *server, Connection *conn) {
+  ssize_t n = recv(conn->fd, conn->in + conn->inLen,
+                   sizeof(conn->in) - conn->inLen, 0);
+  if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+    return;
+  }
+  if (n <= 0) {
+    closeConnection(server, conn); // 클라이언트 종료 또는 오류
+    return;
+  }
+  server->stats.readBatches++;
+  server->stats.bytesIn += n;
+  conn->inLen += (size_t)n;
+
+  size_t batchStart = conn->outLen - conn->outSent;
+  Journal *journal = server->journal;
+  long failuresBefore = journal ? journal->failures : 0;
+  long loggedBefore = journal ? journal->logged : 0;
+  if (!processRequests(server, conn)) {
+    closeConnection(server, conn);
+    return;
+  }
+  // 응답 전에 묶음 전체를 한 번에 fsync. 묶음 중간의 group commit/압축 실패도
+  // failures 로 확인해, 디스크에 없는 변경은 성공으로 응답하지 않음
+  if (!journalCommit(journal) ||
+      (journal != NULL && journal->failures != failuresBefore)) {
+    recoverFailedBatch(server, conn, batchStart, loggedBefore);
+  }
+  if (!flushOutput(server, conn)) {
+    closeConnection(server, conn);
+    return;
+  }
+  updateInterest(server, conn);
+}
+
+/**
+ * @brief 소켓 파일을 만들고 listen 함 (남아 있던 소켓 파일은 지움)
+ * @return listen 소켓, 실패 시 -1
+ */
+int openServerSocket(const char *path) {
+  struct sockaddr_un addr;
+  if (strlen(path) >= sizeof(addr.sun_path)) {
+    fprintf(stderr, "오류: 소켓 경로가 너무 깁니다: %s\n", path);
+    return -1;
+  }
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+
+  // 이전 실행이 남긴 소켓 파일만 지움 (일반 파일은 건드리지 않음)
+  struct stat st;
+  if (lstat(path, &st) == 0 && S_ISSOCK(st.st_mode)) {
+    unlink(path);
+  }
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {
+    perror("소켓 생성 실패");
+    return -1;
+  }
+  if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+      listen(fd, SOMAXCONN) < 0 || fcntl(fd, F_SETFL, O_NONBLOCK) < 0) {
+    perror("소켓 bind/listen 실패");
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+#endif
+
+int runServer(const char *path) {
+#ifndef HAVE_SERVER
+  (void)path;
+  printf("서버 모드는 리눅스(epoll)에서만 지원합니다.\n");
+  return 1;
+#else
+  Server server;
+  memset(&server, 0, sizeof(server));
+  server.list = createLinkedList(printContact, freeContactData);
+  if (server.list == NULL) {
+    fprintf(stderr, "오류: 리스트 생성 실패!\n");
+    return 1;
+  }
+  // 응답 전에 묶음마다 commit 하므로 버퍼는 한 묶음보다 크게
+  server.journal = openJournal(JOURNAL_PATH, SNAPSHOT_PATH,
+                               SERVER_JOURNAL_GROUP, SERVER_COMPACT_THRESHOLD);
+  if (server.journal == NULL) {
+    fprintf(stderr, "경고: 저널 생성 실패! 변경 내용이 저장되지 않습니다.\n");
+  }
+  loadFriendList(server.list, server.journal);
+  // DUMP 는 스냅샷으로 읽음
+  if (!enableSnapshots(server.list)) {
+    freeList(&server.list);
+    closeJournal(&server.journal);
+    return 1;
+  }
+
+  server.listenFd = openServerSocket(path);
+  server.epollFd = epoll_create1(0);
+  struct epoll_event ev;
+  ev.events = EPOLLIN;
+  ev.data.ptr = NULL; // NULL 이면 listen 소켓
+  if (server.listenFd < 0 || server.epollFd < 0 ||
+      epoll_ctl(server.epollFd, EPOLL_CTL_ADD, server.listenFd, &ev) < 0) {
+    fprintf(stderr, "오류: 서버 시작 실패!\n");
+    if (server.listenFd >= 0) {
+      close(server.listenFd);
+      unlink(path);
+    }
+    if (server.epollFd >= 0) {
+      close(server.epollFd);
+    }
+    freeList(&server.list);
+    closeJournal(&server.journal);
+    return 1;
+  }
+  signal(SIGINT, onServerSignal);
+  signal(SIGTERM, onServerSignal);
+  signal(SIGPIPE, SIG_IGN);
+  printf("서버 시작: %s (리스트 %d 개, Ctrl+C 로 종료)\n", path,
+         getListSize(server.list));
+  fflush(stdout);
+
+  struct epoll_event events[SERVER_MAX_EVENTS];
+  while (!serverStopping) {
+    int count = epoll_wait(server.epollFd, events, SERVER_MAX_EVENTS, -1);
+    if (count < 0) {
+      if (errno == EINTR) {
+        continue; // 시그널이면 serverStopping 을 다시 확인
+      }
+      perror("epoll_wait 실패");
+      break;
+    }
+    for (int i = 0; i < count && !serverStopping; ++i) {
+      Connection *conn = (Connection *)events[i].data.ptr;
+      if (conn == NULL) {
+        acceptConnections(&server);
+        continue;
+      }
+      if (events[i].events & (EPOLLERR | EPOLLHUP) &&
+          !(events[i].events & EPOLLIN)) {
+        closeConnection(&server, conn);
+        continue;
+      }
+      if (events[i].events & EPOLLOUT) {
+        if (!flushOutput(&server, conn)) {
+          closeConnection(&server, conn);
+          continue;
+        }
+        updateInterest(&server, conn);
+      }
+      if (events[i].events & EPOLLIN) {
+        handleReadable(&server, conn);
+      }
+    }
+  }
+
+  ServerStats *stats = &server.stats;
+  printf("\n서버 종료: 연결 %lld 개, 요청 %lld 개 (잘못된 요청 %lld), "
+         "읽기 %lld 번, 쓰기 %lld 번, 받음 %lld B, 보냄 %lld B\n",
+         stats->connections, stats->requests, stats->badRequests,
+         stats->readBatches, stats->writeCalls, stats->bytesIn,
+         stats->bytesOut);
+  while (server.connections != NULL) {
+    closeConnection(&server, server.connections);
+  }
+  close(server.listenFd);
+  close(server.epollFd);
+  unlink(path);
+  freeList(&server.list);
+  closeJournal(&server.journal); // 남은 레코드 commit 후 닫기
+  return 0;
+#endif
+}
+
+#ifdef HAVE_SERVER
+// 부하 생성기의 연결 하나
+typedef struct LoadConnection {
+  int fd;
+  int nextId;   // 다음에 추가할 이름 번호 ("L<연결>-<번호>")
+  int deleteId; // 다음에 삭제할 이름 번호 (deleteId ~ nextId-1 이 살아있음)
+  unsigned char in[4096]; // 받은 응답 중 아직 처리하지 않은 바이트
+  size_t inLen;
+  int received; // 이번 요청 묶음에서 받은 응답 수
+} LoadConnection;
+
+/**
+ * @brief 서버 소켓에 연결 (blocking)
+ * @return 연결된 소켓, 실패 시 -1
+ */
+int connectServer(const char *path) {
+  struct sockaddr_un addr;
+  if (strlen(path) >= sizeof(addr.sun_path)) {
+    return -1;
+  }
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {
+    return -1;
+  }
+  if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+/**
+ * @brief 요청 프레임 하나를 out 에 씀
+ * @return 쓴 바이트 수
+ */
+size_t encodeRequest(unsigned char *out, ServerOp op, int position, int count,
+                     const char *name) {
+  size_t bodyLength = 0;
+  unsigned char *body = out + 5;
+  if (op == SERVER_OP_INSERT) {
+    putInt32(body, position);
+    bodyLength += 4;
+  }
+  if (op == SERVER_OP_APPEND || op == SERVER_OP_INSERT) {
+    putInt32(body + bodyLength, count);
+    bodyLength += 4;
+  }
+  if (name != NULL) {
+    size_t nameLength = strlen(name);
+    memcpy(body + bodyLength, name, nameLength);
+    bodyLength += nameLength;
+  }
+  uint32_t length = (uint32_t)(1 + bodyLength);
+  memcpy(out, &length, sizeof(length));
+  out[4] = (unsigned char)op;
+  return 5 + bodyLength;
+}
+
+/**
+ * @brief 버퍼 전체를 보냄 (부분 쓰기 반복)
+ * @return 성공 시 1, 실패 시 0
+ */
+int sendAll(int fd, const unsigned char *data, size_t length) {
+  while (length > 0) {
+    ssize_t n = send(fd, data, length, MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return 0;
+    }
+    data += n;
+    length -= (size_t)n;
+  }
+  return 1;
+}
+
+/**
+ * @brief 정확히 length 바이트를 받음
+ * @return 성공 시 1, 연결 종료나 오류 시 0
+ */
+int receiveAll(int fd, unsigned char *data, size_t length) {
+  while (length > 0) {
+    ssize_t n = recv(fd, data, length, 0);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return 0;
+    }
+    data += n;
+    length -= (size_t)n;
+  }
+  return 1;
+}
+
+/**
+ * @brief 본문 없는 요청 하나를 보내고 응답 하나를 받음 (크기를 모르는
+ * DUMP/STATS 용)
+ * @param body 응답 본문을 저장할 포인터 (호출자가 free)
+ * @param bodyLength 응답 본문 길이
+ * @return 응답 상태, 실패 시 -1
+ */
+int requestOnce(int fd, ServerOp op, unsigned char **body,
+                uint32_t *bodyLength) {
+  unsigned char request[4 + SERVER_MAX_FRAME];
+  size_t requestLength = encodeRequest(request, op, 0, 0, NULL);
+  uint32_t length;
+  unsigned char status;
+  if (!sendAll(fd, request, requestLength) ||
+      !receiveAll(fd, (unsigned char *)&length, sizeof(length)) ||
+      length < 1 || !receiveAll(fd, &status, 1)) {
+    return -1;
+  }
+  *bodyLength = length - 1;
+  *body = (unsigned char *)malloc(*bodyLength + 1);
+  if (*body == NULL || !receiveAll(fd, *body, *bodyLength)) {
+    free(*body);
+    *body = NULL;
+    return -1;
+  }
+  return status;
+}
+
+/**
+ * @brief 연결에서 한 번 읽고, 완성된 응답 프레임마다 도착한 시각으로 지연
+ * 시간을 기록 (poll 이 읽을 수 있다고 알린 연결에만 호출하므로 막히지 않음)
+ * @param conn 대상 연결 (conn->received 가 늘어남)
+ * @param expected 이번 묶음에서 받을 응답 수
+ * @param sentAt 요청 묶음을 보낸 시각
+ * @param latencies 이번 묶음의 지연 시간(초)을 기록할 위치
+ * @param failures 성공이 아닌 응답 수 (누적)
+ * @return 성공 시 1, 연결 오류 시 0
+ */
+int readResponses(LoadConnection *conn, int expected, double sentAt,
+                  double *latencies, long *failures) {
+  ssize_t n = recv(conn->fd, conn->in + conn->inLen,
+                   sizeof(conn->in) - conn->inLen, 0);
+  if (n < 0 && errno == EINTR) {
+    return 1;
+  }
+  if (n <= 0) {
+    return 0;
+  }
+  conn->inLen += (size_t)n;
+  double arrivedAt = wallSeconds();
+  // 버퍼에 완성된 프레임을 모두 처리
+  size_t pos = 0;
+  while (conn->received < expected && conn->inLen - pos >= 5) {
+    uint32_t length;
+    memcpy(&length, conn->in + pos, sizeof(length));
+    if (length < 1 || length > sizeof(conn->in) - 4) {
+      return 0;
+    }
+    if (conn->inLen - pos - 4 < length) {
+      break;
+    }
+    if (conn->in[pos + 4] != SERVER_OK) {
+      (*failures)++;
+    }
+    latencies[conn->received++] = arrivedAt - sentAt;
+    pos += 4 + length;
+  }
+  memmove(conn->in, conn->in + pos, conn->inLen - pos);
+  conn->inLen -= pos;
+  return 1;
+}
+
+/**
+ * @brief DUMP 응답 본문 ([i32 n] + n 개의 [i32 count][u8 길이][이름]) 을
+ * 끝까지 따라가며 형식을 확인
+ * @return 항목 수, 형식이 잘못되었으면 -1
+ */
+int countDumpEntries(const unsigned char *body, uint32_t bodyLength) {
+  if (bodyLength < 4) {
+    return -1;
+  }
+  int count = getInt32(body);
+  size_t pos = 4;
+  for (int i = 0; i < count; ++i) {
+    if (bodyLength - pos < 5) {
+      return -1;
+    }
+    size_t nameLength = body[pos + 4];
+    if (nameLength < 1 || nameLength > 19 ||
+        bodyLength - pos - 5 < nameLength ||
+        memchr(body + pos + 5, '\0', nameLength) != NULL) {
+      return -1;
+    }
+    pos += 5 + nameLength;
+  }
+  return (count >= 0 && pos == bodyLength) ? count : -1;
+}
+
+/**
+ * @brief qsort 용 double 비교 함수
+ */
+int compareDouble(const void *a, const void *b) {
+  double x = *(const double *)a;
+  double y = *(const double *)b;
+  return (x > y) - (x < y);
+}
+#endif
+
+int runLoadClient(const char *path) {
+#ifndef HAVE_SERVER
+  (void)path;
+  printf("부하 생성기는 리눅스에서만 지원합니다.\n");
+  return 1;
+#else
+  const int perConnection = LOAD_REQUESTS / LOAD_CONNECTIONS;
+  const int total = perConnection * LOAD_CONNECTIONS;
+  LoadConnection *conns =
+      (LoadConnection *)calloc(LOAD_CONNECTIONS, sizeof(LoadConnection));
+  double *latencies = (double *)malloc(sizeof(double) * total);
+  unsigned char *request =
+      (unsigned char *)malloc((size_t)LOAD_DEPTH * (4 + SERVER_MAX_FRAME));
+  if (conns == NULL || latencies == NULL || request == NULL) {
+    fprintf(stderr, "오류: 부하 생성기 메모리 할당 실패!\n");
+    free(conns);
+    free(latencies);
+    free(request);
+    return 1;
+  }
+  int connected = 0;
+  for (; connected < LOAD_CONNECTIONS; ++connected) {
+    conns[connected].fd = connectServer(path);
+    if (conns[connected].fd < 0) {
+      fprintf(stderr, "오류: 서버(%s)에 연결할 수 없습니다.\n", path);
+      break;
+    }
+  }
+  int failed = connected < LOAD_CONNECTIONS;
+  printf("부하 생성: 연결 %d 개, 요청 %d 개, 연결마다 %d 개씩 pipelining\n",
+         LOAD_CONNECTIONS, total, LOAD_DEPTH);
+
+  // 끝에 추가 35%, 맨 앞 삽입 10%, 이름으로 삭제 45%, 크기 10% -
+  // 추가와 삭제가 비슷해서 리스트가 길어지지 않음
+  unsigned int seed = 31337u;
+  long failures = 0;
+  int done = 0; // 연결마다 보낸 요청 수
+  char name[20];
+  double *sentAt = (double *)malloc(sizeof(double) * LOAD_CONNECTIONS);
+  failed = failed || sentAt == NULL;
+  double start = wallSeconds();
+  while (!failed && done < perConnection) {
+    int window = perConnection - done < LOAD_DEPTH ? perConnection - done
+                                                   : LOAD_DEPTH;
+    // 모든 연결에 요청 묶음을 보내고, 그다음 응답을 받음
+    for (int c = 0; c < LOAD_CONNECTIONS && !failed; ++c) {
+      LoadConnection *conn = &conns[c];
+      size_t length = 0;
+      for (int k = 0; k < window; ++k) {
+        unsigned int r = benchRandom(&seed) % 100;
+        if (r >= 35 && r < 80 && conn->deleteId < conn->nextId) {
+          snprintf(name, sizeof(name), "L%d-%d", c, conn->deleteId++);
+          length += encodeRequest(request + length, SERVER_OP_DELETE, 0, 0,
+                                  name);
+        } else if (r >= 90) {
+          length += encodeRequest(request + length, SERVER_OP_SIZE, 0, 0,
+                                  NULL);
+        } else {
+          snprintf(name, sizeof(name), "L%d-%d", c, conn->nextId++);
+          length += encodeRequest(request + length,
+                                  r < 80 ? SERVER_OP_APPEND : SERVER_OP_INSERT,
+                                  0, (int)(r % 97), name);
+        }
+      }
+      sentAt[c] = wallSeconds();
+      failed = !sendAll(conn->fd, request, length);
+    }
+    // 모든 연결을 함께 poll 해서, 응답은 도착한 순서대로 받아 시각을 기록
+    // (연결을 하나씩 기다리면 뒤 연결의 응답은 앞 연결을 기다린 만큼 늦게 셈)
+    for (int c = 0; c < LOAD_CONNECTIONS; ++c) {
+      conns[c].received = 0;
+    }
+    int waiting = failed ? 0 : LOAD_CONNECTIONS;
+    while (waiting > 0) {
+      struct pollfd fds[LOAD_CONNECTIONS];
+      int owners[LOAD_CONNECTIONS]; // fds[i] 의 연결 번호
+      int count = 0;
+      for (int c = 0; c < LOAD_CONNECTIONS; ++c) {
+        if (conns[c].received < window) {
+          fds[count].fd = conns[c].fd;
+          fds[count].events = POLLIN;
+          fds[count].revents = 0;
+          owners[count++] = c;
+        }
+      }
+      if (poll(fds, (nfds_t)count, -1) < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        failed = 1;
+        break;
+      }
+      for (int i = 0; i < count && !failed; ++i) {
+        if (fds[i].revents == 0) {
+          continue;
+        }
+        int c = owners[i];
+        failed = !readResponses(&conns[c], window, sentAt[c],
+                                latencies + (size_t)c * perConnection + done,
+                                &failures);
+        if (conns[c].received == window) {
+          waiting--;
+        }
+      }
+      if (failed) {
+        break;
+      }
+    }
+    done += window;
+  }
+  double elapsed = wallSeconds() - start;
+
+  if (failed) {
+    fprintf(stderr, "오류: 요청 전송/응답 수신 실패!\n");
+  } else {
+    qsort(latencies, total, sizeof(double), compareDouble);
+    const double percentiles[] = {50.0, 90.0, 99.0, 99.9};
+    printf("  처리량 : %10.0f 요청/초 (%.3f 초, 실패 응답 %ld 개)\n",
+           total / elapsed, elapsed, failures);
+    printf("  지연   :");
+    for (int i = 0; i < 4; ++i) {
+      int index = (int)(percentiles[i] / 100.0 * (total - 1));
+      printf(" p%g %.1f us,", percentiles[i], latencies[index] * 1e6);
+    }
+    printf(" 최대 %.1f us\n", latencies[total - 1] * 1e6);
+
+    // 서버 통계와 전체 목록 크기 확인
+    unsigned char *body = NULL;
+    uint32_t bodyLength = 0;
+    long long listSize = -1;
+    if (requestOnce(conns[0].fd, SERVER_OP_STATS, &body, &bodyLength) ==
+            SERVER_OK &&
+        bodyLength == 8 * 8) {
+      int64_t v[8];
+      memcpy(v, body, sizeof(v));
+      listSize = (long long)v[7];
+      printf("  서버   : 요청 %lld 개, 읽기 %lld 번, 쓰기 %lld 번 "
+             "(쓰기 한 번에 응답 %.1f 개), 리스트 %lld 개\n",
+             (long long)v[1], (long long)v[3], (long long)v[4],
+             v[4] > 0 ? (double)v[1] / v[4] : 0.0, listSize);
+    } else {
+      fprintf(stderr, "오류: STATS 응답이 잘못되었습니다!\n");
+      failed = 1;
+    }
+    free(body);
+    body = NULL;
+    int dumpCount = -1;
+    if (requestOnce(conns[0].fd, SERVER_OP_DUMP, &body, &bodyLength) ==
+        SERVER_OK) {
+      dumpCount = countDumpEntries(body, bodyLength);
+    }
+    if (dumpCount < 0) {
+      fprintf(stderr, "오류: DUMP 응답을 해석할 수 없습니다!\n");
+      failed = 1;
+    } else {
+      printf("  DUMP   : %d 개, %u B\n", dumpCount, bodyLength);
+      if (listSize >= 0 && dumpCount != listSize) {
+        fprintf(stderr, "오류: DUMP %d 개와 STATS 리스트 %lld 개가 다릅니다!\n",
+                dumpCount, listSize);
+        failed = 1;
+      }
+    }
+    free(body);
+  }
+  for (int c = 0; c < connected; ++c) {
+    close(conns[c].fd);
+  }
+  failed = failed || failures != 0;
+  free(sentAt);
+  free(conns);
+  free(latencies);
+  free(request);
+  return failed;
+#endif
+}
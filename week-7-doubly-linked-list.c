@@ -1,17 +1,80 @@
+#include <stdint.h> // uintptr_t (재배치 블록 범위 검사)
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h> // memcmp, strcmp, strrchr
+#include <time.h>   // clock, timespec_get (벤치마크)
+
+// 입력 파이프라인(reader 스레드 + 링 버퍼)은 C11 스레드/원자 연산이 있을 때만
+#if !defined(__STDC_NO_THREADS__) && !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+#include <threads.h>
+#define HAVE_PIPELINE 1
+#endif
+
+#ifdef _WIN32
+#include <io.h> // _commit, _fileno (저널 fsync)
+#else
+#include <fcntl.h>  // open (스냅샷 교체 후 디렉터리 fsync)
+#include <unistd.h> // fsync (저널 fsync)
+#endif
+
+// 다음에 방문할 노드를 미리 캐시로 가져오는 소프트웨어 prefetch
+#if defined(__GNUC__) || defined(__clang__)
+#define PREFETCH(addr) __builtin_prefetch(addr)
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#define PREFETCH(addr) _mm_prefetch((const char *)(addr), _MM_HINT_T0)
+#else
+#define PREFETCH(addr) ((void)0)
+#endif
 
 // 연결 리스트를 구성하는 노드를 구조체로 정의
 typedef struct Node {
   int data;
   struct Node *next;
   struct Node *prev;
+  int deleted; // 지연 삭제 표시 (tombstone) - 1이면 없는 노드로 취급
 } Node;
 
+#define TOMBSTONE_COMPACT_RATIO 0.25 // 지연 삭제 모드의 기본 정리 비율
+
+// 지연 삭제(tombstone) 모드 상태. 한 번에 한 리스트만 세므로, 다른 리스트를
+// 잠시 만드는 벤치마크는 saveListState/restoreListState 로 감싸서 사용
+int lazyDelete = 0; // 1이면 삭제 시 표시만 하고 나중에 한꺼번에 해제
+double compactRatio = TOMBSTONE_COMPACT_RATIO; // tombstone 비율이 이 값 이상이면 정리
+int nodeCount = 0;      // tombstone 을 포함한 전체 노드 수
+int tombstoneCount = 0; // 아직 해제되지 않은 tombstone 노드 수
+
+// 위 전역 상태를 보관해 두는 구조체
+typedef struct ListState {
+  int lazyDelete;
+  double compactRatio;
+  int nodeCount;
+  int tombstoneCount;
+} ListState;
+
+// defragmentList 가 한 번에 할당한 노드 블록
+Node *nodeBlock = NULL; // 순회 순서대로 연속 배치된 노드 배열
+int blockCount = 0;     // 블록의 원소 수
+int blockLive = 0;      // 블록 안에서 아직 해제되지 않은 노드 수
+
+/**
+ * @brief 현재 리스트의 지연 삭제 상태와 노드 수를 보관하고, 새 리스트를 위해
+ * 기본값(즉시 삭제, 노드 0 개)으로 초기화함
+ * @return 보관한 상태 (restoreListState 에 넘김)
+ */
+ListState saveListState(void);
+
+/**
+ * @brief saveListState 로 보관한 상태를 되돌림 (임시 리스트는 먼저 해제)
+ * @param saved: 보관한 상태
+ */
+void restoreListState(ListState saved);
+
 /**
  * @brief 새로운 노드를 생성함
  * @param data: 노드에 저장할 정수 값
- * @return 생성된 노드의 포인터
+ * @return 생성된 노드의 포인터, 메모리 부족 시 NULL 반환
  */
 Node *createNode(int data);
 
@@ -19,15 +82,16 @@ Node *createNode(int data);
  * @brief 리스트의 맨 앞에 노드를 삽입함
  * @param head: 리스트의 헤드(시작 노드)를 가리키는 포인터의 주소
  * @param data: 삽입할 정수 값
+ * @return 성공 시 1, 실패(메모리 부족) 시 0 반환
  */
-void insertBegin(Node **head, int data);
+int insertBegin(Node **head, int data);
 
 /**
  * @brief 지정한 위치(0부터 시작)에 노드를 삽입함
  * @param head: 리스트의 헤드(시작 노드)를 가리키는 포인터의 주소
  * @param data: 삽입할 정수 값
  * @param index: 삽입할 위치(0부터 시작)
- * @return 성공 시 1, 실패(잘못된 인덱스) 시 0 반환
+ * @return 성공 시 1, 실패(잘못된 인덱스, 메모리 부족) 시 0 반환
  */
 int insertWhere(Node **head, int data, int index);
 
@@ -35,8 +99,9 @@ int insertWhere(Node **head, int data, int index);
  * @brief 리스트의 맨 뒤에 노드를 삽입함
  * @param head: 리스트의 헤드(시작 노드)를 가리키는 포인터의 주소
  * @param data: 삽입할 정수 값
+ * @return 성공 시 1, 실패(메모리 부족) 시 0 반환
  */
-void insertEnd(Node **head, int data);
+int insertEnd(Node **head, int data);
 
 /**
  * @brief 리스트 전체를 처음부터 출력함
@@ -44,16 +109,360 @@ void insertEnd(Node **head, int data);
  */
 void printList(Node *head);
 
+/**
+ * @brief 리스트의 모든 노드를 메모리에서 해제함
+ * @param head: 리스트의 헤드(시작 노드) 포인터
+ */
+void freeList(Node *head);
+
+/**
+ * @brief 지정한 위치(0부터 시작)의 노드를 삭제함
+ * @param head: 리스트의 헤드(시작 노드)를 가리키는 포인터의 주소
+ * @param index: 삭제할 위치(0부터 시작)
+ * @return 성공 시 1, 잘못된 인덱스 입력으로 실패시 0 반환
+ */
+int deleteWhere(Node **head, int index);
+
+/**
+ * @brief tombstone 이 아닌 노드 중 index 번째(0부터 시작) 노드를 찾음
+ * @param head: 리스트의 헤드(시작 노드) 포인터
+ * @param index: 찾을 위치(0부터 시작)
+ * @return 찾은 노드의 포인터, 없으면 NULL 반환
+ */
+Node *findLiveNode(Node *head, int index);
+
+/**
+ * @brief tombstone 노드를 한 번에 모두 연결 해제하고 메모리에서 해제함
+ * @param head: 리스트의 헤드(시작 노드)를 가리키는 포인터의 주소
+ * @return 해제한 노드 수
+ */
+int compactTombstones(Node **head);
+
+/**
+ * @brief 노드 하나를 메모리에서 해제함 (재배치 블록 안의 노드는 블록의 마지막
+ * 노드가 해제될 때 블록째 해제됨). 연결 해제는 호출자가 먼저 해야 함
+ * @param node: 해제할 노드
+ */
+void releaseNode(Node *node);
+
+/**
+ * @brief 노드를 순회 순서대로 연속된 메모리에 다시 배치함 (defragment).
+ * 재배치 후에는 순회가 메모리를 순서대로 읽으므로 캐시 미스가 크게 줄어듦.
+ * tombstone 노드는 이때 함께 정리됨. 블록은 하나뿐이므로 한 리스트에만 사용
+ * @param head: 리스트의 헤드(시작 노드)를 가리키는 포인터의 주소
+ * @return 성공 시 1, 실패(메모리 부족) 시 0 반환 - 실패해도 리스트는 그대로
+ */
+int defragmentList(Node **head);
+
+/**
+ * @brief 노드가 흩어진 리스트의 순회 시간을 defragmentList 전후로 비교함
+ * @return 성공 시 0, 실패 시 1 반환 (main 의 반환값으로 사용)
+ */
+int runDefragBenchmark(void);
+
+#define JOURNAL_PATH "dll.journal"    // 연산 저널 파일
+#define SNAPSHOT_PATH "dll.snapshot"  // 압축된 스냅샷 파일
+#define JOURNAL_GROUP_SIZE 8          // 레코드 몇 개마다 fsync 할지
+#define JOURNAL_COMPACT_THRESHOLD 256 // 저널이 이 개수를 넘으면 압축
+
+// 저널에 기록되는 연산 종류
+typedef enum JournalOp {
+  JOURNAL_INSERT_END = 1, // 맨 뒤에 삽입
+  JOURNAL_INSERT_AT = 2,  // 지정한 위치에 삽입 (맨 앞 삽입은 index 0)
+  JOURNAL_DELETE_AT = 3   // 지정한 위치 삭제
+} JournalOp;
+
+// 저널 레코드 (고정 크기 바이너리, 파일에 그대로 기록)
+typedef struct JournalRecord {
+  unsigned int checksum; // 나머지 필드의 체크섬 (잘린 레코드 검출용)
+  int op;                // JournalOp
+  int index;             // 삽입/삭제 위치
+  int data;              // 삽입할 정수 값
+} JournalRecord;
+
+// 저널/스냅샷 파일 헤더
+typedef struct JournalHeader {
+  char magic[4];           // "DJNL" 또는 "DSNP"
+  unsigned int generation; // 압축할 때마다 1씩 증가
+  int count;               // 스냅샷의 노드 개수 (저널은 0)
+} JournalHeader;
+
+// 저널 관리 구조체
+typedef struct Journal {
+  FILE *fp;                 // 추가 모드로 열린 저널 파일
+  const char *journalPath;  // 저널 파일 경로
+  const char *snapshotPath; // 스냅샷 파일 경로
+  JournalRecord *pending;   // 아직 fsync 되지 않은 레코드 버퍼
+  int pendingCount;         // 버퍼에 쌓인 레코드 수
+  int groupSize;            // group commit 단위 (레코드 수)
+  long recordCount;         // 저널 파일에 기록된 레코드 수
+  long compactThreshold;    // 압축을 시작할 레코드 수
+  unsigned int generation;  // 현재 스냅샷/저널 세대
+  long failures; // 디스크에 남기지 못한 commit/연산 수 (누적, 호출자가 비교)
+  int diverged;  // commit 실패로 디스크가 메모리보다 뒤처졌으면 1 (다음 기록
+                 // 때 레코드 대신 리스트 전체를 스냅샷으로 저장)
+} Journal;
+
+/**
+ * @brief 저널 구조체를 생성함 (파일은 replayJournal/compactJournal 에서 열림)
+ * @param journalPath: 저널 파일 경로
+ * @param snapshotPath: 스냅샷 파일 경로
+ * @param groupSize: 레코드 몇 개마다 fsync 할지 (1이면 매 연산마다)
+ * @param compactThreshold: 저널 레코드가 이 개수 이상이면 스냅샷으로 압축
+ * @return 성공 시 저널 포인터, 실패 시 NULL 반환
+ */
+Journal *openJournal(const char *journalPath, const char *snapshotPath,
+                     int groupSize, long compactThreshold);
+
+/**
+ * @brief 스냅샷과 저널을 읽어 리스트를 복원하고, 저널을 추가 모드로 엶
+ * @param journal: 저널 포인터
+ * @param head: 복원할 (비어있는) 리스트의 헤드 포인터의 주소
+ * @return 저장된 데이터가 있었으면 1, 없었으면(처음 실행) 0 반환
+ */
+int replayJournal(Journal *journal, Node **head);
+
+/**
+ * @brief 연산 하나를 저널 버퍼에 추가함. groupSize 만큼 쌓이면 fsync 하고,
+ * 저널이 compactThreshold 를 넘으면 현재 리스트로 압축함
+ * @param journal: 저널 포인터 (NULL 이면 아무것도 하지 않음)
+ * @param head: 연산이 반영된 현재 리스트의 헤드 (압축 시 스냅샷으로 사용)
+ * @param op: 연산 종류
+ * @param index: 삽입/삭제 위치 (JOURNAL_INSERT_END 는 무시)
+ * @param data: 삽입한 정수 값 (JOURNAL_DELETE_AT 은 무시)
+ */
+void journalLog(Journal *journal, Node *head, JournalOp op, int index,
+                int data);
+
+/**
+ * @brief 버퍼에 쌓인 레코드를 파일에 쓰고 fsync 함 (group commit)
+ * @param journal: 저널 포인터
+ * @return 성공 시 1, 실패 시 0 반환
+ */
+int journalCommit(Journal *journal);
+
+/**
+ * @brief 현재 리스트를 새 스냅샷으로 저장하고 저널을 비움
+ * @param journal: 저널 포인터
+ * @param head: 스냅샷으로 저장할 리스트의 헤드
+ * @return 성공 시 1, 실패 시 0 반환
+ */
+int compactJournal(Journal *journal, Node *head);
+
+/**
+ * @brief 남은 레코드를 commit 하고 저널을 닫은 뒤 메모리를 해제함
+ * @param journal: 해제할 저널 포인터
+ */
+void closeJournal(Journal *journal);
+
+#define INPUT_CHUNK_SIZE 65536 // 입력을 한 번에 읽어 오는 크기 (바이트)
+#define RING_CAPACITY 4096     // 링 버퍼 크기 (2의 거듭제곱)
+#define RING_DRAIN_BATCH 256   // 변경 스레드가 한 번에 꺼내 처리하는 명령 수
+#define RING_SPIN_LIMIT 64     // 링이 비었거나 가득 찼을 때 잠들기 전 양보 횟수
+
+// 파싱된 명령 하나 (메뉴 번호와 그 입력값)
+typedef struct Command {
+  int op;    // 메뉴 번호 (1: 맨 앞, 2: 위치 삽입, 3: 맨 뒤, 4: 위치 삭제, 5, 6)
+  int value; // 삽입할 값 (1, 2, 3)
+  int index; // 삽입/삭제 위치 (2, 4)
+} Command;
+
+// 입력을 큰 덩어리로 읽어 정수를 하나씩 돌려주는 버퍼 (scanf 대신 사용)
+typedef struct InputReader {
+  FILE *fp;
+  char buffer[INPUT_CHUNK_SIZE];
+  size_t pos; // 버퍼에서 다음에 읽을 위치
+  size_t len; // 버퍼에 채워진 바이트 수
+} InputReader;
+
+// 파이프라인/직렬 실행 결과 통계
+typedef struct PipelineStats {
+  long parsed;        // 파싱한 명령 수
+  long invalid;       // 숫자가 아니어서 버린 입력 수
+  long applied;       // 성공한 명령 수
+  long failed;        // 실패한 명령 수 (잘못된 인덱스 등)
+  long batches;       // 변경 스레드가 링에서 꺼낸 묶음 수
+  long producerWaits; // 링이 가득 차서 reader 가 기다린 횟수 (backpressure)
+} PipelineStats;
+
+/**
+ * @brief 저장된 리스트를 복원하고, 없으면 초기값(10, 20, 30)으로 시작함
+ * @param journal: 저널 포인터 (NULL 이면 초기값만 삽입)
+ * @return 리스트의 헤드
+ */
+Node *loadList(Journal *journal);
+
+/**
+ * @brief 메뉴 입력과 같은 형식(공백으로 구분된 정수)의 명령 하나를 파싱함
+ * @param reader: 입력 버퍼
+ * @param cmd: 파싱 결과를 저장할 명령
+ * @return 성공 시 1, 입력 끝(EOF 또는 0번 메뉴) 시 0, 잘못된 입력 시 -1 반환
+ */
+int parseCommand(InputReader *reader, Command *cmd);
+
+/**
+ * @brief 명령 하나를 리스트에 적용하고 저널에 기록함 (출력 없음)
+ * @param head: 리스트의 헤드(시작 노드)를 가리키는 포인터의 주소
+ * @param journal: 저널 포인터 (NULL 이면 기록하지 않음)
+ * @param cmd: 적용할 명령
+ * @return 성공 시 1, 실패 시 0 반환
+ */
+int applyCommand(Node **head, Journal *journal, const Command *cmd);
+
+/**
+ * @brief 한 스레드에서 파싱과 리스트 변경을 번갈아 실행함 (기존 메뉴 루프 방식)
+ * @param reader: 입력 버퍼
+ * @param head: 리스트의 헤드(시작 노드)를 가리키는 포인터의 주소
+ * @param journal: 저널 포인터
+ * @param stats: 결과 통계 (누적됨)
+ */
+void runSerial(InputReader *reader, Node **head, Journal *journal,
+               PipelineStats *stats);
+
+/**
+ * @brief reader 스레드가 입력을 파싱해 링 버퍼에 넣고, 호출한 스레드는 링에서
+ * 명령을 묶음으로 꺼내 리스트에 적용함. C11 스레드가 없으면 runSerial 로 대체
+ * @param reader: 입력 버퍼
+ * @param head: 리스트의 헤드(시작 노드)를 가리키는 포인터의 주소
+ * @param journal: 저널 포인터
+ * @param stats: 결과 통계 (누적됨)
+ */
+void runPipeline(InputReader *reader, Node **head, Journal *journal,
+                 PipelineStats *stats);
+
+/**
+ * @brief 표준 입력의 명령을 파이프라인으로 처리하고 최종 리스트를 출력함
+ * @return 모든 명령이 성공하고 저널에 남았으면 0, 아니면 1 반환 (main 의
+ * 반환값으로 사용)
+ */
+int runPipelineMode(void);
+
+/**
+ * @brief 같은 명령 스트림을 직렬 루프와 파이프라인으로 처리한 처리량을 비교함
+ * @return 성공 시 0, 실패 시 1 반환 (main 의 반환값으로 사용)
+ */
+int runPipelineBenchmark(void);
+
+/**
+ * @brief 삭제 위주 작업에서 즉시 삭제와 지연 삭제(tombstone)의 시간을 비교함
+ * @return 성공 시 0, 실패 시 1 반환 (main 의 반환값으로 사용)
+ */
+int runDeleteBenchmark(void);
+
+#define LRU_DEFAULT_CAPACITY 4 // --lru 모드의 기본 캐시 크기
+
+// LRU 캐시에 저장하는 연락처 레코드
+typedef struct CacheRecord {
+  char name[20]; // 친구 이름
+  int count;     // 카톡 횟수
+} CacheRecord;
+
+// 이중 연결 리스트를 최근 사용 순서로 쓰는 고정 크기 LRU 캐시.
+// 노드의 data 가 키이고, 맨 앞이 가장 최근에 사용한 항목
+typedef struct LruCache {
+  Node *head;           // 가장 최근에 사용한 노드
+  Node *tail;           // 가장 오래 전에 사용한 노드 (교체 대상)
+  Node *nodes;          // capacity 개를 한 번에 할당한 노드 배열
+  CacheRecord *records; // nodes[i] 의 레코드는 records[i]
+  Node **table;         // 키 -> 노드 해시 테이블 (선형 탐사, NULL 이면 빈칸)
+  unsigned int tableMask; // 테이블 크기 - 1 (크기는 2의 거듭제곱)
+  int capacity;           // 최대 항목 수
+  int size;               // 현재 항목 수
+  long hits;              // 조회 성공 수
+  long misses;            // 조회 실패 수
+  long evictions;         // 가득 차서 맨 뒤 항목을 내보낸 수
+} LruCache;
+
+/**
+ * @brief 고정 크기 LRU 캐시를 생성함 (노드와 해시 테이블을 미리 할당)
+ * @param capacity: 최대 항목 수 (1 이상)
+ * @return 생성된 캐시의 포인터, 실패 시 NULL 반환
+ */
+LruCache *createLruCache(int capacity);
+
+/**
+ * @brief 키로 레코드를 조회함. 찾으면 그 노드를 맨 앞으로 옮김 (O(1))
+ * @param cache: 캐시 포인터
+ * @param key: 조회할 키
+ * @return 찾은 레코드의 포인터 (다음 lruPut 전까지 유효), 없으면 NULL 반환
+ */
+const CacheRecord *lruGet(LruCache *cache, int key);
+
+/**
+ * @brief 키와 레코드를 저장하고 맨 앞으로 옮김. 새 키인데 가득 차 있으면 맨 뒤
+ * 항목을 내보냄 (O(1))
+ * @param cache: 캐시 포인터
+ * @param key: 저장할 키
+ * @param record: 저장할 레코드 (복사됨)
+ */
+void lruPut(LruCache *cache, int key, const CacheRecord *record);
+
+/**
+ * @brief 캐시 항목을 최근 사용 순서로 출력하고 조회 통계를 출력함
+ * @param cache: 캐시 포인터
+ */
+void printLruCache(const LruCache *cache);
+
+/**
+ * @brief 캐시의 노드, 레코드, 해시 테이블을 모두 해제함
+ * @param cache: 해제할 캐시 포인터
+ */
+void freeLruCache(LruCache *cache);
+
+/**
+ * @brief 키를 입력받아 조회/저장하는 대화형 LRU 캐시 모드
+ * @param capacity: 캐시 크기
+ * @return 성공 시 0, 실패 시 1 반환 (main 의 반환값으로 사용)
+ */
+int runLruMode(int capacity);
+
+/**
+ * @brief Zipf 분포 접근 기록으로 캐시 크기별 적중률과 처리량을 측정함
+ * @return 성공 시 0, 실패 시 1 반환 (main 의 반환값으로 사용)
+ */
+int runLruBenchmark(void);
+
+/**
+ * @brief 현재 리스트의 지연 삭제 상태와 노드 수를 보관하고, 새 리스트를 위해
+ * 기본값(즉시 삭제, 노드 0 개)으로 초기화함
+ * @return 보관한 상태 (restoreListState 에 넘김)
+ */
+ListState saveListState(void) {
+  ListState saved = {lazyDelete, compactRatio, nodeCount, tombstoneCount};
+  lazyDelete = 0;
+  compactRatio = TOMBSTONE_COMPACT_RATIO;
+  nodeCount = 0;
+  tombstoneCount = 0;
+  return saved;
+}
+
+/**
+ * @brief saveListState 로 보관한 상태를 되돌림 (임시 리스트는 먼저 해제)
+ * @param saved: 보관한 상태
+ */
+void restoreListState(ListState saved) {
+  lazyDelete = saved.lazyDelete;
+  compactRatio = saved.compactRatio;
+  nodeCount = saved.nodeCount;
+  tombstoneCount = saved.tombstoneCount;
+}
+
 /**
  * @brief 새로운 노드를 생성함
  * @param data: 노드에 저장할 정수 값
- * @return 생성된 노드의 포인터
+ * @return 생성된 노드의 포인터, 메모리 부족 시 NULL 반환
  */
 Node *createNode(int data) {
   Node *newNode = (Node *)malloc(sizeof(Node));
+  if (newNode == NULL) {
+    fprintf(stderr, "오류: 노드 메모리 할당 실패!\n");
+    return NULL;
+  }
   newNode->data = data;
   newNode->next = NULL;
   newNode->prev = NULL;
+  newNode->deleted = 0;
+  nodeCount++;
   return newNode;
 }
 
@@ -61,14 +470,18 @@ Node *createNode(int data) {
  * @brief 리스트의 맨 앞에 노드를 삽입함
  * @param head: 리스트의 헤드(시작 노드)를 가리키는 포인터의 주소
  * @param data: 삽입할 정수 값
+ * @return 성공 시 1, 실패(메모리 부족) 시 0 반환
  */
-void insertBegin(Node **head, int data) {
+int insertBegin(Node **head, int data) {
   Node *newNode = createNode(data);
+  if (newNode == NULL)
+    return 0;
   newNode->next = *head;
   if (*head != NULL) {
     (*head)->prev = newNode;
   }
   *head = newNode;
+  return 1;
 }
 
 /**
@@ -76,27 +489,22 @@ void insertBegin(Node **head, int data) {
  * @param head: 리스트의 헤드(시작 노드)를 가리키는 포인터의 주소
  * @param data: 삽입할 정수 값
  * @param index: 삽입할 위치(0부터 시작)
- * @return 성공 시 1, 실패(잘못된 인덱스) 시 0 반환
+ * @return 성공 시 1, 실패(잘못된 인덱스, 메모리 부족) 시 0 반환
  */
 int insertWhere(Node **head, int data, int index) {
   // 인덱스가 0보다 작으면 실패
   if (index < 0)
     return 0;
 
-  if (index == 0) {
-    insertBegin(head, data);
-    return 1;
-  }
-  Node *temp = *head;
-  int i = 0;
-  // 삽입할 위치 바로 앞 노드로 이동
-  while (temp != NULL && i < index - 1) {
-    temp = temp->next;
-    i++;
-  }
+  if (index == 0)
+    return insertBegin(head, data);
+  // 삽입할 위치 바로 앞 노드로 이동 (tombstone 은 세지 않음)
+  Node *temp = findLiveNode(*head, index - 1);
   if (temp == NULL)
     return 0; // 잘못된 인덱스 입력으로 실패
   Node *newNode = createNode(data);
+  if (newNode == NULL)
+    return 0;
   newNode->next = temp->next;
   newNode->prev = temp;
   if (temp->next != NULL) {
@@ -110,12 +518,15 @@ int insertWhere(Node **head, int data, int index) {
  * @brief 리스트의 맨 뒤에 노드를 삽입함
  * @param head: 리스트의 헤드(시작 노드)를 가리키는 포인터의 주소
  * @param data: 삽입할 정수 값
+ * @return 성공 시 1, 실패(메모리 부족) 시 0 반환
  */
-void insertEnd(Node **head, int data) {
+int insertEnd(Node **head, int data) {
   Node *newNode = createNode(data);
+  if (newNode == NULL)
+    return 0;
   if (*head == NULL) {
     *head = newNode;
-    return;
+    return 1;
   }
   Node *temp = *head;
   while (temp->next != NULL) {
@@ -123,6 +534,7 @@ void insertEnd(Node **head, int data) {
   }
   temp->next = newNode;
   newNode->prev = temp;
+  return 1;
 }
 
 /**
@@ -132,7 +544,9 @@ void insertEnd(Node **head, int data) {
 void printList(Node *head) {
   Node *temp = head;
   while (temp != NULL) {
-    printf("%d ", temp->data);
+    PREFETCH(temp->next); // 출력하는 동안 다음 노드를 미리 가져옴
+    if (!temp->deleted)
+      printf("%d ", temp->data);
     temp = temp->next;
   }
   printf("\n");
@@ -147,7 +561,11 @@ void freeList(Node *head) {
   while (head != NULL) {
     temp = head;
     head = head->next;
-    free(temp);
+    PREFETCH(head);
+    if (temp->deleted)
+      tombstoneCount--;
+    nodeCount--;
+    releaseNode(temp);
   }
 }
 
@@ -160,94 +578,1627 @@ void freeList(Node *head) {
 int deleteWhere(Node **head, int index) {
   if (*head == NULL || index < 0)
     return 0;
-  Node *temp = *head;
-  int i = 0;
-  // 첫 번째 노드인 헤드 삭제
-  if (index == 0) {
-    *head = temp->next;
-    if (*head != NULL)
-      (*head)->prev = NULL;
-    free(temp);
-    return 1;
-  }
-  // 삭제할 위치까지 이동
-  while (temp != NULL && i < index) {
-    temp = temp->next;
-    i++;
-  }
+  // 삭제할 위치까지 이동 (tombstone 은 세지 않음)
+  Node *temp = findLiveNode(*head, index);
   if (temp == NULL)
     return 0; // 잘못된 인덱스 입력으로 실패했을 때 반환값
+  if (lazyDelete) {
+    // 지연 삭제: 표시만 하고 바로 반환, 해제는 compactTombstones 에서 모아서
+    temp->deleted = 1;
+    tombstoneCount++;
+    if (tombstoneCount >= compactRatio * nodeCount)
+      compactTombstones(head);
+    return 1;
+  }
   if (temp->prev != NULL)
     temp->prev->next = temp->next;
+  else
+    *head = temp->next; // 첫 번째 노드인 헤드 삭제
   if (temp->next != NULL)
     temp->next->prev = temp->prev;
-  free(temp);
+  releaseNode(temp);
+  nodeCount--;
   return 1;
 }
 
-int main() {
-  Node *head = NULL;
-  int choice, value, index;
+/**
+ * @brief tombstone 이 아닌 노드 중 index 번째(0부터 시작) 노드를 찾음
+ * @param head: 리스트의 헤드(시작 노드) 포인터
+ * @param index: 찾을 위치(0부터 시작)
+ * @return 찾은 노드의 포인터, 없으면 NULL 반환
+ */
+Node *findLiveNode(Node *head, int index) {
+  if (index < 0)
+    return NULL;
+  Node *temp = head;
+  while (temp != NULL) {
+    PREFETCH(temp->next);
+    if (!temp->deleted && index-- == 0)
+      return temp;
+    temp = temp->next;
+  }
+  return NULL;
+}
 
-  // 초기값 설정: 10, 20, 30을 순서대로 삽입
-  insertEnd(&head, 10);
-  insertEnd(&head, 20);
-  insertEnd(&head, 30);
+/**
+ * @brief tombstone 노드를 한 번에 모두 연결 해제하고 메모리에서 해제함
+ * @param head: 리스트의 헤드(시작 노드)를 가리키는 포인터의 주소
+ * @return 해제한 노드 수
+ */
+int compactTombstones(Node **head) {
+  int removed = 0;
+  Node *temp = *head;
+  while (temp != NULL && tombstoneCount > 0) {
+    Node *next = temp->next;
+    if (temp->deleted) {
+      if (temp->prev != NULL)
+        temp->prev->next = next;
+      else
+        *head = next;
+      if (next != NULL)
+        next->prev = temp->prev;
+      releaseNode(temp);
+      nodeCount--;
+      tombstoneCount--;
+      removed++;
+    }
+    temp = next;
+  }
+  return removed;
+}
 
-  printf("\n[초기 리스트] ");
-  printList(head);
+/**
+ * @brief 노드 하나를 메모리에서 해제함 (재배치 블록 안의 노드는 블록의 마지막
+ * 노드가 해제될 때 블록째 해제됨). 연결 해제는 호출자가 먼저 해야 함
+ * @param node: 해제할 노드
+ */
+void releaseNode(Node *node) {
+  uintptr_t p = (uintptr_t)node;
+  uintptr_t start = (uintptr_t)nodeBlock;
+  if (nodeBlock == NULL || p < start || p >= start + blockCount * sizeof(Node)) {
+    free(node);
+    return;
+  }
+  if (--blockLive == 0) {
+    free(nodeBlock);
+    nodeBlock = NULL;
+    blockCount = 0;
+  }
+}
 
-  while (1) {
-    // 각 기능 실행 후 리스트 출력
-    printf("\n[현재 리스트] ");
-    printList(head);
-    printf("\n");
+/**
+ * @brief 노드를 순회 순서대로 연속된 메모리에 다시 배치함 (defragment).
+ * 재배치 후에는 순회가 메모리를 순서대로 읽으므로 캐시 미스가 크게 줄어듦.
+ * tombstone 노드는 이때 함께 정리됨. 블록은 하나뿐이므로 한 리스트에만 사용
+ * @param head: 리스트의 헤드(시작 노드)를 가리키는 포인터의 주소
+ * @return 성공 시 1, 실패(메모리 부족) 시 0 반환 - 실패해도 리스트는 그대로
+ */
+int defragmentList(Node **head) {
+  int count = nodeCount - tombstoneCount;
+  Node *nodes = NULL;
+  if (count > 0) {
+    nodes = (Node *)malloc(sizeof(Node) * count);
+    if (nodes == NULL)
+      return 0;
+  }
 
-    printf("\n원하는 작업을 선택하세요:\n");
-    printf("1: 맨 앞에 삽입\n");
-    printf("2: 원하는 위치에 삽입\n");
-    printf("3: 맨 뒤에 삽입\n");
-    printf("4: 원하는 위치 삭제\n");
-    printf("0: 종료\n");
-    printf("번호를 입력하세요: ");
-    if (scanf("%d", &choice) != 1) {
-      while (getchar() != '\n')
-        ;
-      printf("잘못된 입력입니다.\n");
-      break;
+  // 살아있는 노드를 순서대로 새 블록에 복사하고, 옛 노드는 해제
+  int i = 0;
+  Node *temp = *head;
+  while (temp != NULL) {
+    Node *next = temp->next;
+    PREFETCH(next);
+    if (!temp->deleted) {
+      nodes[i].data = temp->data;
+      nodes[i].deleted = 0;
+      nodes[i].prev = (i > 0) ? &nodes[i - 1] : NULL;
+      nodes[i].next = (i + 1 < count) ? &nodes[i + 1] : NULL;
+      i++;
     }
-    if (choice == 0)
-      break;
-    switch (choice) {
-    case 1:
-      printf("맨 앞에 삽입할 값을 입력하세요: ");
-      scanf("%d", &value);
-      insertBegin(&head, value);
-      break;
-    case 2:
-      printf("삽입할 값을 입력하세요: ");
-      scanf("%d", &value);
-      printf("삽입할 위치(인덱스)를 입력하세요: ");
-      scanf("%d", &index);
-      if (!insertWhere(&head, value, index))
-        printf("잘못된 인덱스입니다.\n");
-      break;
-    case 3:
-      printf("맨 뒤에 삽입할 값을 입력하세요: ");
-      scanf("%d", &value);
-      insertEnd(&head, value);
-      break;
-    case 4:
-      printf("삭제할 위치(인덱스)를 입력하세요: ");
-      scanf("%d", &index);
-      if (!deleteWhere(&head, index))
-        printf("잘못된 인덱스입니다.\n");
+    releaseNode(temp); // 이전 블록은 마지막 노드에서 함께 해제됨
+    temp = next;
+  }
+
+  nodeBlock = nodes;
+  blockCount = count;
+  blockLive = count;
+  nodeCount = count;
+  tombstoneCount = 0;
+  *head = nodes;
+  return 1;
+}
+
+/**
+ * @brief 파일 버퍼를 비우고 디스크에 기록될 때까지 대기함 (fsync)
+ * @param fp: 대상 파일
+ * @return 성공 시 1, 실패 시 0 반환
+ */
+int syncFile(FILE *fp) {
+  if (fflush(fp) != 0)
+    return 0;
+#ifdef _WIN32
+  return _commit(_fileno(fp)) == 0;
+#else
+  return fsync(fileno(fp)) == 0;
+#endif
+}
+
+/**
+ * @brief path 가 들어 있는 디렉터리를 fsync 함 (rename 결과를 디스크에 남김).
+ * Windows 는 디렉터리를 열어 _commit 할 수 없고 NTFS 가 메타데이터를
+ * 저널링하므로 아무것도 하지 않음
+ * @param path: 디렉터리 안의 파일 경로
+ * @return 성공 시 1, 실패 시 0 반환
+ */
+int syncDirectory(const char *path) {
+#ifdef _WIN32
+  (void)path;
+  return 1;
+#else
+  char dir[256];
+  const char *slash = strrchr(path, '/');
+  if (slash == NULL)
+    snprintf(dir, sizeof(dir), ".");
+  else if (slash == path)
+    snprintf(dir, sizeof(dir), "/");
+  else
+    snprintf(dir, sizeof(dir), "%.*s", (int)(slash - path), path);
+  int fd = open(dir, O_RDONLY);
+  if (fd < 0)
+    return 0;
+  int ok = fsync(fd) == 0;
+  close(fd);
+  return ok;
+#endif
+}
+
+/**
+ * @brief 레코드의 checksum 필드를 제외한 나머지에 대한 FNV-1a 해시를 계산함
+ * @param record: 대상 레코드
+ * @return 체크섬 값
+ */
+unsigned int journalChecksum(const JournalRecord *record) {
+  const unsigned char *bytes = (const unsigned char *)&record->op;
+  size_t length = sizeof(JournalRecord) - sizeof(record->checksum);
+  unsigned int hash = 2166136261u;
+  for (size_t i = 0; i < length; i++) {
+    hash ^= bytes[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+/**
+ * @brief 헤더만 있는 새 저널 파일을 만들고 fsync 함 (기존 내용은 버림)
+ * @param journal: 저널 포인터
+ * @return 성공 시 1, 실패 시 0 반환
+ */
+int resetJournalFile(Journal *journal) {
+  if (journal->fp != NULL) {
+    fclose(journal->fp);
+    journal->fp = NULL;
+  }
+  FILE *fp = fopen(journal->journalPath, "wb");
+  if (fp == NULL) {
+    perror("저널 파일 생성 실패");
+    return 0;
+  }
+  JournalHeader header = {{'D', 'J', 'N', 'L'}, journal->generation, 0};
+  if (fwrite(&header, sizeof(header), 1, fp) != 1 || !syncFile(fp)) {
+    perror("저널 헤더 기록 실패");
+    fclose(fp);
+    return 0;
+  }
+  journal->fp = fp;
+  journal->recordCount = 0;
+  journal->pendingCount = 0;
+  journal->diverged = 0;
+  return 1;
+}
+
+/**
+ * @brief 실패한 commit 이 남긴 불완전한 레코드를 잘라 내고 저널을 다시 엶.
+ * 잘라 내지 않으면 이후 레코드가 손상된 레코드 뒤에 붙어 복원 시 버려짐
+ * @param journal: 저널 포인터
+ * @return 성공 시 1, 실패 시 0 반환
+ */
+int truncateJournal(Journal *journal) {
+  long offset = (long)sizeof(JournalHeader) +
+                journal->recordCount * (long)sizeof(JournalRecord);
+  fclose(journal->fp); // 버퍼에 남은 조각도 함께 버려짐 (곧 잘라 냄)
+  journal->fp = fopen(journal->journalPath, "ab");
+  if (journal->fp == NULL) {
+    perror("저널 파일 다시 열기 실패");
+    return 0;
+  }
+#ifdef _WIN32
+  int ok = _chsize(_fileno(journal->fp), offset) == 0;
+#else
+  int ok = ftruncate(fileno(journal->fp), (off_t)offset) == 0;
+#endif
+  if (!ok || !syncFile(journal->fp)) {
+    perror("저널 잘라 내기 실패");
+    return 0;
+  }
+  return 1;
+}
+
+/**
+ * @brief 저널 구조체를 생성함 (파일은 replayJournal/compactJournal 에서 열림)
+ * @param journalPath: 저널 파일 경로
+ * @param snapshotPath: 스냅샷 파일 경로
+ * @param groupSize: 레코드 몇 개마다 fsync 할지 (1이면 매 연산마다)
+ * @param compactThreshold: 저널 레코드가 이 개수 이상이면 스냅샷으로 압축
+ * @return 성공 시 저널 포인터, 실패 시 NULL 반환
+ */
+Journal *openJournal(const char *journalPath, const char *snapshotPath,
+                     int groupSize, long compactThreshold) {
+  if (groupSize < 1)
+    groupSize = 1;
+  Journal *journal = (Journal *)malloc(sizeof(Journal));
+  if (journal == NULL)
+    return NULL;
+  journal->pending = (JournalRecord *)malloc(sizeof(JournalRecord) * groupSize);
+  if (journal->pending == NULL) {
+    free(journal);
+    return NULL;
+  }
+  journal->fp = NULL;
+  journal->journalPath = journalPath;
+  journal->snapshotPath = snapshotPath;
+  journal->pendingCount = 0;
+  journal->groupSize = groupSize;
+  journal->recordCount = 0;
+  journal->compactThreshold = compactThreshold;
+  journal->generation = 0;
+  journal->failures = 0;
+  journal->diverged = 0;
+  return journal;
+}
+
+/**
+ * @brief 스냅샷과 저널을 읽어 리스트를 복원하고, 저널을 추가 모드로 엶
+ * @param journal: 저널 포인터
+ * @param head: 복원할 (비어있는) 리스트의 헤드 포인터의 주소
+ * @return 저장된 데이터가 있었으면 1, 없었으면(처음 실행) 0 반환
+ */
+int replayJournal(Journal *journal, Node **head) {
+  int restored = 0;
+  int needsCompaction = 0; // 저널 끝이 손상된 경우 압축으로 정리
+  Node *tail = NULL;       // 마지막 노드 (스냅샷은 O(1) 로 이어붙임)
+  JournalHeader header;
+
+  // 1) 스냅샷 읽기: 순서대로 저장되어 있으므로 tail 뒤에 바로 연결
+  FILE *fp = fopen(journal->snapshotPath, "rb");
+  if (fp != NULL) {
+    if (fread(&header, sizeof(header), 1, fp) == 1 &&
+        memcmp(header.magic, "DSNP", 4) == 0) {
+      restored = 1;
+      journal->generation = header.generation;
+      int value;
+      for (int i = 0; i < header.count; i++) {
+        if (fread(&value, sizeof(value), 1, fp) != 1) {
+          fprintf(stderr, "경고: 스냅샷이 %d번째 항목에서 잘렸습니다.\n", i);
+          break;
+        }
+        Node *newNode = createNode(value);
+        if (newNode == NULL)
+          break;
+        if (tail == NULL) {
+          *head = newNode;
+        } else {
+          tail->next = newNode;
+          newNode->prev = tail;
+        }
+        tail = newNode;
+      }
+    } else {
+      fprintf(stderr, "경고: 스냅샷 헤더가 올바르지 않아 무시합니다.\n");
+    }
+    fclose(fp);
+  }
+
+  // 2) 같은 세대의 저널 레코드를 순서대로 다시 적용
+  fp = fopen(journal->journalPath, "rb");
+  if (fp != NULL) {
+    if (fread(&header, sizeof(header), 1, fp) == 1 &&
+        memcmp(header.magic, "DJNL", 4) == 0 &&
+        header.generation == journal->generation) {
+      restored = 1;
+      JournalRecord record;
+      size_t got;
+      while ((got = fread(&record, 1, sizeof(record), fp)) == sizeof(record)) {
+        if (record.checksum != journalChecksum(&record)) {
+          got = 1; // 손상된 레코드 - 이후는 모두 버림
+          break;
+        }
+        journal->recordCount++;
+        if (record.op == JOURNAL_INSERT_END) {
+          // 마지막 노드를 기억해 두고 끝까지 다시 탐색하지 않음
+          Node *newNode = createNode(record.data);
+          if (newNode == NULL)
+            continue;
+          if (tail == NULL && *head != NULL) {
+            tail = *head;
+            while (tail->next != NULL)
+              tail = tail->next;
+          }
+          if (tail == NULL) {
+            *head = newNode;
+          } else {
+            tail->next = newNode;
+            newNode->prev = tail;
+          }
+          tail = newNode;
+        } else if (record.op == JOURNAL_INSERT_AT) {
+          insertWhere(head, record.data, record.index);
+          tail = NULL;
+        } else if (record.op == JOURNAL_DELETE_AT) {
+          deleteWhere(head, record.index);
+          tail = NULL;
+        }
+      }
+      if (got != 0) {
+        fprintf(stderr, "경고: 저널 끝의 불완전한 레코드를 버립니다.\n");
+        needsCompaction = 1;
+      }
+    } else {
+      // 이전 세대의 저널 (압축 도중 종료) 이거나 손상된 헤더
+      needsCompaction = 1;
+    }
+    fclose(fp);
+  } else if (restored) {
+    needsCompaction = 1; // 스냅샷만 있고 저널이 없음
+  }
+
+  // 3) 이후 연산을 기록할 저널 열기
+  if (!restored)
+    return 0; // 처음 실행 - 호출자가 초기 데이터 삽입 후 compactJournal 호출
+  if (needsCompaction) {
+    compactJournal(journal, *head);
+  } else {
+    journal->fp = fopen(journal->journalPath, "ab");
+    if (journal->fp == NULL)
+      perror("저널 파일 열기 실패");
+  }
+  return 1;
+}
+
+/**
+ * @brief 버퍼에 쌓인 레코드를 파일에 쓰고 fsync 함 (group commit)
+ * @param journal: 저널 포인터
+ * @return 성공 시 1, 실패 시 0 반환
+ */
+int journalCommit(Journal *journal) {
+  if (journal == NULL || journal->fp == NULL || journal->pendingCount == 0)
+    return 1;
+  size_t written = fwrite(journal->pending, sizeof(JournalRecord),
+                          journal->pendingCount, journal->fp);
+  int complete = written == (size_t)journal->pendingCount;
+  int count = journal->pendingCount;
+  journal->pendingCount = 0;
+  if (!complete || !syncFile(journal->fp)) {
+    // 일부만 쓰였어도 실패. 파일은 마지막으로 commit 한 위치로 되돌리고,
+    // 버퍼의 연산은 메모리에만 있으므로 다음 기록 때 스냅샷으로 맞춤
+    perror("저널 기록 실패");
+    journal->failures++;
+    journal->diverged = 1;
+    truncateJournal(journal);
+    return 0;
+  }
+  journal->recordCount += count;
+  return 1;
+}
+
+/**
+ * @brief 연산 하나를 저널 버퍼에 추가함. groupSize 만큼 쌓이면 fsync 하고,
+ * 저널이 compactThreshold 를 넘으면 현재 리스트로 압축함
+ * @param journal: 저널 포인터 (NULL 이면 아무것도 하지 않음)
+ * @param head: 연산이 반영된 현재 리스트의 헤드 (압축 시 스냅샷으로 사용)
+ * @param op: 연산 종류
+ * @param index: 삽입/삭제 위치 (JOURNAL_INSERT_END 는 무시)
+ * @param data: 삽입한 정수 값 (JOURNAL_DELETE_AT 은 무시)
+ */
+void journalLog(Journal *journal, Node *head, JournalOp op, int index,
+                int data) {
+  if (journal == NULL)
+    return;
+  // 이전 commit/압축이 실패해 버퍼가 가득 차 있으면 먼저 비움
+  if (journal->fp != NULL && journal->pendingCount >= journal->groupSize)
+    journalCommit(journal);
+  // 디스크가 메모리를 놓쳤으면 (commit 실패, 저널 파일 없음) 레코드를 덧붙여도
+  // 복원할 수 없으므로, 이 연산까지 반영된 리스트 전체를 스냅샷으로 저장
+  if (journal->fp == NULL || journal->diverged) {
+    if (!compactJournal(journal, head))
+      journal->failures++;
+    return;
+  }
+  JournalRecord *record = &journal->pending[journal->pendingCount++];
+  record->op = op;
+  record->index = index;
+  record->data = data;
+  record->checksum = journalChecksum(record);
+
+  // 저널이 너무 길어지면 리스트 전체를 스냅샷으로 압축 (버퍼 내용도 포함됨)
+  if (journal->recordCount + journal->pendingCount >=
+      journal->compactThreshold) {
+    if (!compactJournal(journal, head))
+      journalCommit(journal); // 압축에 실패하면 저널에라도 기록
+    return;
+  }
+  // group commit: groupSize 개가 모일 때마다 한 번만 fsync
+  if (journal->pendingCount >= journal->groupSize)
+    journalCommit(journal);
+}
+
+/**
+ * @brief 현재 리스트를 새 스냅샷으로 저장하고 저널을 비움
+ * @param journal: 저널 포인터
+ * @param head: 스냅샷으로 저장할 리스트의 헤드
+ * @return 성공 시 1, 실패 시 0 반환
+ */
+int compactJournal(Journal *journal, Node *head) {
+  if (journal == NULL)
+    return 0;
+
+  int count = 0;
+  for (Node *temp = head; temp != NULL; temp = temp->next)
+    if (!temp->deleted)
+      count++;
+
+  // 임시 파일에 새 세대의 스냅샷을 쓰고 fsync 한 뒤 교체
+  char tempPath[256];
+  snprintf(tempPath, sizeof(tempPath), "%s.tmp", journal->snapshotPath);
+  FILE *fp = fopen(tempPath, "wb");
+  if (fp == NULL) {
+    perror("스냅샷 파일 생성 실패");
+    return 0;
+  }
+  JournalHeader header = {{'D', 'S', 'N', 'P'}, journal->generation + 1,
+                          count};
+  int ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+  for (Node *temp = head; ok && temp != NULL; temp = temp->next)
+    if (!temp->deleted)
+      ok = fwrite(&temp->data, sizeof(temp->data), 1, fp) == 1;
+  ok = ok && syncFile(fp);
+  fclose(fp);
+  if (!ok) {
+    perror("스냅샷 기록 실패");
+    remove(tempPath);
+    return 0;
+  }
+#ifdef _WIN32
+  remove(journal->snapshotPath); // Windows 의 rename 은 덮어쓰지 않음
+#endif
+  if (rename(tempPath, journal->snapshotPath) != 0) {
+    perror("스냅샷 교체 실패");
+    remove(tempPath);
+    return 0;
+  }
+  // 교체가 디스크에 남기 전에 저널을 비우면, 충돌 후 옛 스냅샷과 빈 새 세대
+  // 저널이 짝지어져 그 사이 연산이 사라지므로 디렉터리까지 fsync
+  if (!syncDirectory(journal->snapshotPath))
+    perror("경고: 스냅샷 디렉터리 fsync 실패");
+  journal->generation++;
+  return resetJournalFile(journal);
+}
+
+/**
+ * @brief 남은 레코드를 commit 하고 저널을 닫은 뒤 메모리를 해제함
+ * @param journal: 해제할 저널 포인터
+ */
+void closeJournal(Journal *journal) {
+  if (journal == NULL)
+    return;
+  journalCommit(journal);
+  if (journal->fp != NULL)
+    fclose(journal->fp);
+  free(journal->pending);
+  free(journal);
+}
+
+/**
+ * @brief 벤치마크용 xorshift 난수 (rand 의 RAND_MAX 가 작은 환경 대비)
+ * @param state: 난수 상태 (호출할 때마다 갱신됨)
+ * @return 32비트 난수
+ */
+unsigned int benchRandom(unsigned int *state) {
+  unsigned int x = *state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *state = x;
+  return x;
+}
+
+/**
+ * @brief 삭제 위주 작업 한 번을 실행하고 걸린 시간(초)을 반환함
+ * @param size: 처음 리스트 크기
+ * @param lazy: 지연 삭제 모드 여부
+ * @param ratio: 지연 삭제 모드의 정리 비율
+ * @param randomIndex: 1이면 무작위 위치, 0이면 항상 맨 앞(0번) 삭제
+ * @return 걸린 시간(초)
+ */
+double timeDeleteWorkload(int size, int lazy, double ratio, int randomIndex) {
+  ListState saved = saveListState(); // 이 리스트의 노드만 세도록
+  Node *head = NULL;
+  Node *tail = NULL;
+  for (int i = 0; i < size; i++) {
+    Node *newNode = createNode(i);
+    if (newNode == NULL)
+      break; // 메모리가 부족하면 만든 만큼으로 측정
+    if (tail == NULL) {
+      head = newNode;
+    } else {
+      tail->next = newNode;
+      newNode->prev = tail;
+    }
+    tail = newNode;
+  }
+  lazyDelete = lazy;
+  compactRatio = ratio;
+
+  // 90% 를 삭제하면서 삭제 10번마다 새 값 하나를 맨 앞에 삽입
+  unsigned int seed = 12345u; // 모든 모드가 같은 위치 순서를 사용
+  int live = size;
+  int deletes = size - size / 10;
+  clock_t start = clock();
+  for (int i = 0; i < deletes; i++) {
+    int index = randomIndex ? (int)(benchRandom(&seed) % (unsigned int)live) : 0;
+    if (deleteWhere(&head, index))
+      live--;
+    if (i % 10 == 9 && insertBegin(&head, -i))
+      live++;
+  }
+  compactTombstones(&head); // 남은 tombstone 정리까지 포함해서 측정
+  double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+  freeList(head);
+  restoreListState(saved);
+  return seconds;
+}
+
+/**
+ * @brief 삭제 위주 작업에서 즉시 삭제와 지연 삭제(tombstone)의 시간을 비교함
+ * @return 성공 시 0, 실패 시 1 반환 (main 의 반환값으로 사용)
+ */
+int runDeleteBenchmark(void) {
+  const int size = 20000;
+  const double ratios[] = {0.1, 0.25, 0.5};
+  const char *orderNames[] = {"맨 앞", "무작위 위치"};
+
+  printf("삭제 위주 벤치마크: %d 개 중 90%% 삭제 (삭제 10번마다 삽입 1번)\n",
+         size);
+  for (int randomIndex = 0; randomIndex <= 1; randomIndex++) {
+    printf("\n[삭제 위치: %s]\n", orderNames[randomIndex]);
+    double eager = timeDeleteWorkload(size, 0, 0.0, randomIndex);
+    printf("  즉시 삭제                : %8.3f ms\n", eager * 1000.0);
+    for (int i = 0; i < (int)(sizeof(ratios) / sizeof(ratios[0])); i++) {
+      double lazy = timeDeleteWorkload(size, 1, ratios[i], randomIndex);
+      printf("  지연 삭제 (정리 비율 %.2f): %8.3f ms (즉시 삭제 대비 %.2fx)\n",
+             ratios[i], lazy * 1000.0, lazy > 0 ? eager / lazy : 0.0);
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief 노드 순서와 메모리 순서가 무작위로 섞인 리스트를 만듦.
+ * 노드를 모두 할당한 뒤 섞인 순서로 연결하므로 순회할 때마다 메모리를
+ * 건너뛰며 읽게 됨 (오래 사용한 리스트를 흉내)
+ * @param size: 노드 수
+ * @return 리스트의 헤드, 실패 시 NULL 반환
+ */
+Node *buildShuffledList(int size) {
+  Node **nodes = (Node **)malloc(sizeof(Node *) * size);
+  if (nodes == NULL)
+    return NULL;
+  for (int i = 0; i < size; i++) {
+    nodes[i] = createNode(i);
+    if (nodes[i] == NULL) {
+      while (i-- > 0) {
+        nodeCount--;
+        releaseNode(nodes[i]);
+      }
+      free(nodes);
+      return NULL;
+    }
+  }
+  unsigned int seed = 2024u;
+  for (int i = size - 1; i > 0; i--) {
+    int j = (int)(benchRandom(&seed) % (unsigned int)(i + 1));
+    Node *t = nodes[i];
+    nodes[i] = nodes[j];
+    nodes[j] = t;
+  }
+  for (int i = 0; i < size; i++) {
+    nodes[i]->prev = (i > 0) ? nodes[i - 1] : NULL;
+    nodes[i]->next = (i + 1 < size) ? nodes[i + 1] : NULL;
+  }
+  Node *head = nodes[0];
+  free(nodes);
+  return head;
+}
+
+/**
+ * @brief 값 합계(printList 와 같은 순회)와 마지막 위치 찾기(insertWhere,
+ * deleteWhere 의 위치 세기)를 repeat 번 반복한 시간(초)을 측정함
+ * @param head: 리스트의 헤드
+ * @param size: 살아있는 노드 수
+ * @param repeat: 반복 횟수
+ * @param check: 결과값 누적 (컴파일러가 순회를 없애지 못하게 함)
+ * @return 걸린 시간(초)
+ */
+double timeTraversal(Node *head, int size, int repeat, long *check) {
+  clock_t start = clock();
+  for (int r = 0; r < repeat; r++) {
+    for (Node *temp = head; temp != NULL; temp = temp->next) {
+      PREFETCH(temp->next);
+      if (!temp->deleted)
+        *check += temp->data;
+    }
+    *check += findLiveNode(head, size - 1)->data;
+  }
+  return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+/**
+ * @brief 노드가 흩어진 리스트의 순회 시간을 defragmentList 전후로 비교함
+ * @return 성공 시 0, 실패 시 1 반환 (main 의 반환값으로 사용)
+ */
+int runDefragBenchmark(void) {
+  const int size = 500000;
+  const int repeat = 10;
+  long check = 0;
+
+  ListState saved = saveListState(); // 이 리스트의 노드만 세도록
+  Node *head = buildShuffledList(size);
+  if (head == NULL) {
+    fprintf(stderr, "오류: 벤치마크 메모리 할당 실패!\n");
+    restoreListState(saved);
+    return 1;
+  }
+  printf("순회 벤치마크: 노드 %d 개가 섞인 리스트, 순회 %d 번 "
+         "(값 합계 + 마지막 위치 찾기)\n",
+         size, repeat);
+  double before = timeTraversal(head, size, repeat, &check);
+
+  clock_t start = clock();
+  if (!defragmentList(&head)) {
+    fprintf(stderr, "오류: 재배치 실패!\n");
+    freeList(head);
+    restoreListState(saved);
+    return 1;
+  }
+  double defragTime = (double)(clock() - start) / CLOCKS_PER_SEC;
+  double after = timeTraversal(head, size, repeat, &check);
+
+  printf("  재배치 전 순회 : %9.3f ms\n", before * 1000.0);
+  printf("  재배치 소요    : %9.3f ms\n", defragTime * 1000.0);
+  printf("  재배치 후 순회 : %9.3f ms (%.2fx)\n", after * 1000.0,
+         after > 0 ? before / after : 0.0);
+  printf("  (검증값 %ld)\n", check);
+  freeList(head);
+  restoreListState(saved);
+  return 0;
+}
+
+/**
+ * @brief 입력 버퍼에서 문자 하나를 읽음 (비었으면 fread 로 한 번에 채움)
+ * @param reader: 입력 버퍼
+ * @return 읽은 문자, 입력 끝이면 EOF 반환
+ */
+int nextInputChar(InputReader *reader) {
+  if (reader->pos == reader->len) {
+    reader->len = fread(reader->buffer, 1, sizeof(reader->buffer), reader->fp);
+    reader->pos = 0;
+    if (reader->len == 0)
+      return EOF;
+  }
+  return (unsigned char)reader->buffer[reader->pos++];
+}
+
+/**
+ * @brief 공백을 건너뛰고 정수 하나를 읽음 (scanf("%d") 와 같은 입력 형식)
+ * @param reader: 입력 버퍼
+ * @param value: 읽은 값을 저장할 주소
+ * @return 성공 시 1, 입력 끝이면 0, 숫자가 아닌 토큰이면 -1 반환 (토큰은 버림)
+ */
+int readInputInt(InputReader *reader, int *value) {
+  int c = nextInputChar(reader);
+  while (c == ' ' || c == '\t' || c == '\n' || c == '\r')
+    c = nextInputChar(reader);
+  if (c == EOF)
+    return 0;
+
+  int negative = 0;
+  if (c == '-' || c == '+') {
+    negative = (c == '-');
+    c = nextInputChar(reader);
+  }
+  int digits = 0;
+  long result = 0;
+  while (c >= '0' && c <= '9') {
+    result = result * 10 + (c - '0');
+    digits++;
+    c = nextInputChar(reader);
+  }
+  // 토큰의 나머지(숫자가 아닌 문자)는 버림
+  int valid = digits > 0;
+  while (c != EOF && c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+    valid = 0;
+    c = nextInputChar(reader);
+  }
+  if (!valid)
+    return -1;
+  *value = (int)(negative ? -result : result);
+  return 1;
+}
+
+/**
+ * @brief 메뉴 입력과 같은 형식(공백으로 구분된 정수)의 명령 하나를 파싱함
+ * @param reader: 입력 버퍼
+ * @param cmd: 파싱 결과를 저장할 명령
+ * @return 성공 시 1, 입력 끝(EOF 또는 0번 메뉴) 시 0, 잘못된 입력 시 -1 반환
+ */
+int parseCommand(InputReader *reader, Command *cmd) {
+  int result = readInputInt(reader, &cmd->op);
+  if (result <= 0)
+    return result;
+  if (cmd->op == 0)
+    return 0; // 0번 메뉴 = 입력 끝
+  cmd->value = 0;
+  cmd->index = 0;
+
+  // 메뉴 번호에 따라 이어지는 값을 읽음 (대화형 입력과 같은 순서)
+  if (cmd->op >= 1 && cmd->op <= 3) {
+    result = readInputInt(reader, &cmd->value);
+    if (result <= 0)
+      return result;
+  }
+  if (cmd->op == 2 || cmd->op == 4) {
+    result = readInputInt(reader, &cmd->index);
+    if (result <= 0)
+      return result;
+  }
+  return (cmd->op >= 1 && cmd->op <= 6) ? 1 : -1;
+}
+
+/**
+ * @brief 명령 하나를 리스트에 적용하고 저널에 기록함 (출력 없음)
+ * @param head: 리스트의 헤드(시작 노드)를 가리키는 포인터의 주소
+ * @param journal: 저널 포인터 (NULL 이면 기록하지 않음)
+ * @param cmd: 적용할 명령
+ * @return 성공 시 1, 실패 시 0 반환
+ */
+int applyCommand(Node **head, Journal *journal, const Command *cmd) {
+  switch (cmd->op) {
+  case 1:
+    if (!insertBegin(head, cmd->value))
+      return 0;
+    journalLog(journal, *head, JOURNAL_INSERT_AT, 0, cmd->value);
+    return 1;
+  case 2:
+    if (!insertWhere(head, cmd->value, cmd->index))
+      return 0;
+    journalLog(journal, *head, JOURNAL_INSERT_AT, cmd->index, cmd->value);
+    return 1;
+  case 3:
+    if (!insertEnd(head, cmd->value))
+      return 0;
+    journalLog(journal, *head, JOURNAL_INSERT_END, -1, cmd->value);
+    return 1;
+  case 4:
+    if (!deleteWhere(head, cmd->index))
+      return 0;
+    journalLog(journal, *head, JOURNAL_DELETE_AT, cmd->index, 0);
+    return 1;
+  case 5:
+    lazyDelete = !lazyDelete;
+    if (!lazyDelete)
+      compactTombstones(head); // 즉시 삭제 모드에서는 tombstone 을 남기지 않음
+    return 1;
+  case 6:
+    return defragmentList(head);
+  default:
+    return 0;
+  }
+}
+
+/**
+ * @brief 한 스레드에서 파싱과 리스트 변경을 번갈아 실행함 (기존 메뉴 루프 방식)
+ * @param reader: 입력 버퍼
+ * @param head: 리스트의 헤드(시작 노드)를 가리키는 포인터의 주소
+ * @param journal: 저널 포인터
+ * @param stats: 결과 통계 (누적됨)
+ */
+void runSerial(InputReader *reader, Node **head, Journal *journal,
+               PipelineStats *stats) {
+  Command cmd;
+  int result;
+  while ((result = parseCommand(reader, &cmd)) != 0) {
+    if (result < 0) {
+      stats->invalid++;
+      continue;
+    }
+    stats->parsed++;
+    if (applyCommand(head, journal, &cmd))
+      stats->applied++;
+    else
+      stats->failed++;
+  }
+}
+
+#ifdef HAVE_PIPELINE
+// reader(생산자) 하나, 변경 스레드(소비자) 하나만 쓰는 lock-free 링 버퍼.
+// head 는 생산자만, tail 은 소비자만 쓰므로 잠금 없이 acquire/release 로 충분.
+// 링이 오래 비거나 가득 차 있으면 기다리는 쪽은 조건 변수에서 잠들고, 상대는
+// 대기 플래그가 켜져 있을 때만 잠금을 잡고 깨움 (평소에는 잠금 없음)
+typedef struct CommandRing {
+  Command slots[RING_CAPACITY];
+  _Alignas(64) atomic_size_t head; // 다음에 쓸 위치 (생산자)
+  _Alignas(64) atomic_size_t tail; // 다음에 읽을 위치 (소비자)
+  atomic_int done;                 // 생산자가 입력을 모두 넣었으면 1
+  atomic_int consumerWaiting;      // 소비자가 notEmpty 에서 잠들었으면 1
+  atomic_int producerWaiting;      // 생산자가 notFull 에서 잠들었으면 1
+  mtx_t lock;                      // 잠들기/깨우기용 잠금
+  cnd_t notEmpty;                  // 명령이 들어왔거나 입력이 끝남
+  cnd_t notFull;                   // 소비자가 자리를 비움
+} CommandRing;
+
+// reader 스레드에 넘기는 인자
+typedef struct ReaderContext {
+  CommandRing *ring;
+  InputReader *reader;
+  long parsed;
+  long invalid;
+  long producerWaits;
+} ReaderContext;
+
+/**
+ * @brief 상대 스레드가 잠들어 있으면 깨움. 호출 전에 head/tail/done 을
+ * seq_cst 로 저장해야 잠들기 직전의 상대와 엇갈리지 않음
+ * @param ring: 링 버퍼
+ * @param waiting: 상대의 대기 플래그
+ * @param cond: 상대가 기다리는 조건 변수
+ */
+void wakeRingWaiter(CommandRing *ring, atomic_int *waiting, cnd_t *cond) {
+  if (!atomic_load(waiting))
+    return;
+  mtx_lock(&ring->lock);
+  cnd_signal(cond);
+  mtx_unlock(&ring->lock);
+}
+
+/**
+ * @brief reader 스레드: 입력을 파싱해 링에 넣음. 링이 가득 차면 소비자가
+ * 자리를 비울 때까지 양보하다가 잠들어 기다림 (backpressure)
+ * @param arg: ReaderContext 포인터
+ * @return 항상 0
+ */
+int readerThreadMain(void *arg) {
+  ReaderContext *ctx = (ReaderContext *)arg;
+  CommandRing *ring = ctx->ring;
+  size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+  size_t tailCache = atomic_load_explicit(&ring->tail, memory_order_acquire);
+  Command cmd;
+  int result;
+
+  while ((result = parseCommand(ctx->reader, &cmd)) != 0) {
+    if (result < 0) {
+      ctx->invalid++;
+      continue;
+    }
+    // 가득 찼으면 소비자의 tail 을 다시 읽고, 그래도 가득이면 대기
+    int spins = 0;
+    while (head - tailCache == RING_CAPACITY) {
+      tailCache = atomic_load_explicit(&ring->tail, memory_order_acquire);
+      if (head - tailCache != RING_CAPACITY)
+        break;
+      ctx->producerWaits++;
+      if (++spins < RING_SPIN_LIMIT) {
+        thrd_yield();
+        continue;
+      }
+      // 오래 가득 차 있으면 소비자가 깨울 때까지 잠듦
+      mtx_lock(&ring->lock);
+      atomic_store(&ring->producerWaiting, 1);
+      while (head - atomic_load(&ring->tail) == RING_CAPACITY)
+        cnd_wait(&ring->notFull, &ring->lock);
+      atomic_store(&ring->producerWaiting, 0);
+      mtx_unlock(&ring->lock);
+      spins = 0;
+    }
+    ring->slots[head & (RING_CAPACITY - 1)] = cmd;
+    head++;
+    atomic_store(&ring->head, head); // seq_cst: 잠드는 소비자와 엇갈리지 않게
+    wakeRingWaiter(ring, &ring->consumerWaiting, &ring->notEmpty);
+    ctx->parsed++;
+  }
+  atomic_store(&ring->done, 1);
+  wakeRingWaiter(ring, &ring->consumerWaiting, &ring->notEmpty);
+  return 0;
+}
+
+/**
+ * @brief 링 버퍼의 잠금과 조건 변수를 정리하고 메모리를 해제함
+ * @param ring: 해제할 링 버퍼
+ */
+void destroyRing(CommandRing *ring) {
+  cnd_destroy(&ring->notFull);
+  cnd_destroy(&ring->notEmpty);
+  mtx_destroy(&ring->lock);
+  free(ring);
+}
+#endif
+
+/**
+ * @brief reader 스레드가 입력을 파싱해 링 버퍼에 넣고, 호출한 스레드는 링에서
+ * 명령을 묶음으로 꺼내 리스트에 적용함. C11 스레드가 없으면 runSerial 로 대체
+ * @param reader: 입력 버퍼
+ * @param head: 리스트의 헤드(시작 노드)를 가리키는 포인터의 주소
+ * @param journal: 저널 포인터
+ * @param stats: 결과 통계 (누적됨)
+ */
+void runPipeline(InputReader *reader, Node **head, Journal *journal,
+                 PipelineStats *stats) {
+#ifdef HAVE_PIPELINE
+  CommandRing *ring = (CommandRing *)malloc(sizeof(CommandRing));
+  if (ring == NULL) {
+    runSerial(reader, head, journal, stats);
+    return;
+  }
+  atomic_init(&ring->head, 0);
+  atomic_init(&ring->tail, 0);
+  atomic_init(&ring->done, 0);
+  atomic_init(&ring->consumerWaiting, 0);
+  atomic_init(&ring->producerWaiting, 0);
+  int lockReady = mtx_init(&ring->lock, mtx_plain) == thrd_success;
+  int emptyReady = lockReady && cnd_init(&ring->notEmpty) == thrd_success;
+  int fullReady = emptyReady && cnd_init(&ring->notFull) == thrd_success;
+  if (!fullReady) {
+    if (emptyReady)
+      cnd_destroy(&ring->notEmpty);
+    if (lockReady)
+      mtx_destroy(&ring->lock);
+    free(ring);
+    runSerial(reader, head, journal, stats);
+    return;
+  }
+
+  ReaderContext ctx = {ring, reader, 0, 0, 0};
+  thrd_t readerThread;
+  if (thrd_create(&readerThread, readerThreadMain, &ctx) != thrd_success) {
+    destroyRing(ring);
+    runSerial(reader, head, journal, stats);
+    return;
+  }
+
+  // 변경 스레드(현재 스레드): 쌓인 명령을 최대 RING_DRAIN_BATCH 개씩 처리하고
+  // tail 은 묶음마다 한 번만 갱신
+  size_t tail = 0;
+  int spins = 0;
+  while (1) {
+    size_t ringHead = atomic_load_explicit(&ring->head, memory_order_acquire);
+    if (ringHead == tail) {
+      if (atomic_load_explicit(&ring->done, memory_order_acquire) &&
+          atomic_load_explicit(&ring->head, memory_order_acquire) == tail)
+        break; // 입력 끝, 남은 명령 없음
+      if (++spins < RING_SPIN_LIMIT) {
+        thrd_yield();
+        continue;
+      }
+      // 오래 비어 있으면 (터미널 입력 대기 등) reader 가 깨울 때까지 잠듦
+      mtx_lock(&ring->lock);
+      atomic_store(&ring->consumerWaiting, 1);
+      while (atomic_load(&ring->head) == tail && !atomic_load(&ring->done))
+        cnd_wait(&ring->notEmpty, &ring->lock);
+      atomic_store(&ring->consumerWaiting, 0);
+      mtx_unlock(&ring->lock);
+      spins = 0;
+      continue;
+    }
+    spins = 0;
+    size_t available = ringHead - tail;
+    size_t batch = available < RING_DRAIN_BATCH ? available : RING_DRAIN_BATCH;
+    for (size_t i = 0; i < batch; i++) {
+      const Command *cmd = &ring->slots[(tail + i) & (RING_CAPACITY - 1)];
+      if (applyCommand(head, journal, cmd))
+        stats->applied++;
+      else
+        stats->failed++;
+    }
+    tail += batch;
+    atomic_store(&ring->tail, tail); // seq_cst: 잠드는 생산자와 엇갈리지 않게
+    wakeRingWaiter(ring, &ring->producerWaiting, &ring->notFull);
+    stats->batches++;
+  }
+
+  thrd_join(readerThread, NULL);
+  stats->parsed += ctx.parsed;
+  stats->invalid += ctx.invalid;
+  stats->producerWaits += ctx.producerWaits;
+  destroyRing(ring);
+#else
+  runSerial(reader, head, journal, stats);
+#endif
+}
+
+/**
+ * @brief 저장된 리스트를 복원하고, 없으면 초기값(10, 20, 30)으로 시작함
+ * @param journal: 저널 포인터 (NULL 이면 초기값만 삽입)
+ * @return 리스트의 헤드
+ */
+Node *loadList(Journal *journal) {
+  Node *head = NULL;
+  if (journal == NULL || !replayJournal(journal, &head)) {
+    // 초기값 설정: 10, 20, 30을 순서대로 삽입
+    insertEnd(&head, 10);
+    insertEnd(&head, 20);
+    insertEnd(&head, 30);
+    compactJournal(journal, head); // 초기값을 첫 스냅샷으로 저장
+  }
+  return head;
+}
+
+/**
+ * @brief 표준 입력의 명령을 파이프라인으로 처리하고 최종 리스트를 출력함
+ * @return 모든 명령이 성공하고 저널에 남았으면 0, 아니면 1 반환 (main 의
+ * 반환값으로 사용)
+ */
+int runPipelineMode(void) {
+  InputReader *reader = (InputReader *)malloc(sizeof(InputReader));
+  if (reader == NULL)
+    return 1;
+  Journal *journal = openJournal(JOURNAL_PATH, SNAPSHOT_PATH,
+                                 JOURNAL_GROUP_SIZE, JOURNAL_COMPACT_THRESHOLD);
+  if (journal == NULL)
+    fprintf(stderr, "경고: 저널 생성 실패! 변경 내용이 저장되지 않습니다.\n");
+  Node *head = loadList(journal);
+
+  reader->fp = stdin;
+  reader->pos = 0;
+  reader->len = 0;
+  PipelineStats stats = {0, 0, 0, 0, 0, 0};
+  runPipeline(reader, &head, journal, &stats);
+  int ok = stats.failed == 0 && stats.invalid == 0 &&
+           (journal == NULL || journal->failures == 0);
+
+  printf("[최종 리스트] ");
+  printList(head);
+  printf("명령 %ld 개 처리 (성공 %ld, 실패 %ld, 잘못된 입력 %ld), "
+         "묶음 %ld 번, reader 대기 %ld 번\n",
+         stats.parsed, stats.applied, stats.failed, stats.invalid,
+         stats.batches, stats.producerWaits);
+
+  closeJournal(journal);
+  freeList(head);
+  free(reader);
+  return ok ? 0 : 1;
+}
+
+/**
+ * @brief 벽시계 시간(초)을 반환함 - 여러 스레드를 쓰므로 clock() 대신 사용
+ * @return 현재 시각(초)
+ */
+double wallSeconds(void) {
+  struct timespec ts;
+  timespec_get(&ts, TIME_UTC);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief 같은 명령 스트림을 직렬 루프와 파이프라인으로 처리한 처리량을 비교함.
+ * 명령은 맨 앞 삽입, 앞쪽(0~3) 위치 삽입, 앞쪽 위치 삭제를 섞어 리스트를 짧게
+ * 유지하므로 파싱과 리스트 변경의 비용이 비슷함
+ * @return 성공 시 0, 실패 시 1 반환 (main 의 반환값으로 사용)
+ */
+int runPipelineBenchmark(void) {
+  const int count = 1000000;
+  FILE *fp = tmpfile();
+  InputReader *reader = (InputReader *)malloc(sizeof(InputReader));
+  if (fp == NULL || reader == NULL) {
+    fprintf(stderr, "오류: 벤치마크 준비 실패!\n");
+    if (fp != NULL)
+      fclose(fp);
+    free(reader);
+    return 1;
+  }
+  unsigned int seed = 777u;
+  int size = 0; // 명령을 만들면서 추적하는 리스트 크기
+  for (int i = 0; i < count; i++) {
+    unsigned int r = benchRandom(&seed);
+    int maxIndex = size < 3 ? size : 3;
+    if (size > 0 && (size >= 16 || (r & 1))) {
+      fprintf(fp, "4 %d\n", (int)((r >> 1) % (unsigned int)size % 4));
+      size--;
+    } else if (r & 2) {
+      fprintf(fp, "1 %d\n", i);
+      size++;
+    } else {
+      fprintf(fp, "2 %d %d\n", i, (int)((r >> 2) % (unsigned int)(maxIndex + 1)));
+      size++;
+    }
+  }
+  fprintf(fp, "0\n");
+
+  printf("입력 파이프라인 벤치마크: 명령 %d 개 (앞쪽 삽입/삭제)\n", count);
+  const char *modeNames[] = {"직렬 루프", "파이프라인"};
+  double elapsed[2] = {0.0, 0.0};
+  for (int mode = 0; mode < 2; mode++) {
+    ListState saved = saveListState(); // 모드마다 빈 리스트부터 셈
+    Node *head = NULL;
+    rewind(fp);
+    reader->fp = fp;
+    reader->pos = 0;
+    reader->len = 0;
+    PipelineStats stats = {0, 0, 0, 0, 0, 0};
+
+    double start = wallSeconds();
+    if (mode == 0)
+      runSerial(reader, &head, NULL, &stats);
+    else
+      runPipeline(reader, &head, NULL, &stats);
+    elapsed[mode] = wallSeconds() - start;
+
+    printf("  %s: %8.3f ms, %10.0f 명령/초 (성공 %ld, 실패 %ld",
+           modeNames[mode], elapsed[mode] * 1000.0,
+           elapsed[mode] > 0 ? stats.parsed / elapsed[mode] : 0.0,
+           stats.applied, stats.failed);
+    if (mode == 1)
+      printf(", 묶음 %ld 번, reader 대기 %ld 번", stats.batches,
+             stats.producerWaits);
+    printf(")\n");
+    freeList(head);
+    restoreListState(saved);
+  }
+  if (elapsed[1] > 0)
+    printf("  파이프라인 / 직렬 처리량: %.2fx\n", elapsed[0] / elapsed[1]);
+  fclose(fp);
+  free(reader);
+  return 0;
+}
+
+/**
+ * @brief 키의 해시 테이블 시작 위치를 구함 (곱셈 해시)
+ * @param cache: 캐시 포인터
+ * @param key: 키
+ * @return 테이블 인덱스
+ */
+unsigned int lruSlot(const LruCache *cache, int key) {
+  return ((unsigned int)key * 2654435761u) & cache->tableMask;
+}
+
+/**
+ * @brief 키를 가진 노드가 있는 해시 테이블 위치를 찾음
+ * @param cache: 캐시 포인터
+ * @param key: 찾을 키
+ * @return 노드가 있으면 그 위치, 없으면 탐사가 멈춘 빈칸의 위치 반환
+ */
+unsigned int lruFindSlot(const LruCache *cache, int key) {
+  unsigned int i = lruSlot(cache, key);
+  while (cache->table[i] != NULL && cache->table[i]->data != key)
+    i = (i + 1) & cache->tableMask;
+  return i;
+}
+
+/**
+ * @brief 해시 테이블에서 노드를 지우고, 뒤따르던 항목을 앞으로 당겨 탐사가
+ * 끊기지 않게 함 (삭제 표시 없이 backward shift)
+ * @param cache: 캐시 포인터
+ * @param key: 지울 키 (테이블에 있어야 함)
+ */
+void lruRemoveKey(LruCache *cache, int key) {
+  unsigned int hole = lruFindSlot(cache, key);
+  unsigned int i = hole;
+  cache->table[hole] = NULL;
+  while (1) {
+    i = (i + 1) & cache->tableMask;
+    if (cache->table[i] == NULL)
+      return;
+    // i 의 항목이 원래 자리(home)에서 hole 을 지나왔으면 hole 로 옮김
+    unsigned int home = lruSlot(cache, cache->table[i]->data);
+    if (((i - home) & cache->tableMask) >= ((i - hole) & cache->tableMask)) {
+      cache->table[hole] = cache->table[i];
+      cache->table[i] = NULL;
+      hole = i;
+    }
+  }
+}
+
+/**
+ * @brief 노드를 최근 사용 리스트에서 떼어냄 (prev/next 만 고침)
+ * @param cache: 캐시 포인터
+ * @param node: 떼어낼 노드
+ */
+void lruDetach(LruCache *cache, Node *node) {
+  if (node->prev != NULL)
+    node->prev->next = node->next;
+  else
+    cache->head = node->next;
+  if (node->next != NULL)
+    node->next->prev = node->prev;
+  else
+    cache->tail = node->prev;
+}
+
+/**
+ * @brief 노드를 최근 사용 리스트의 맨 앞에 붙임
+ * @param cache: 캐시 포인터
+ * @param node: 붙일 노드 (리스트에서 떨어져 있어야 함)
+ */
+void lruPushFront(LruCache *cache, Node *node) {
+  node->prev = NULL;
+  node->next = cache->head;
+  if (cache->head != NULL)
+    cache->head->prev = node;
+  else
+    cache->tail = node;
+  cache->head = node;
+}
+
+/**
+ * @brief 고정 크기 LRU 캐시를 생성함 (노드와 해시 테이블을 미리 할당)
+ * @param capacity: 최대 항목 수 (1 이상)
+ * @return 생성된 캐시의 포인터, 실패 시 NULL 반환
+ */
+LruCache *createLruCache(int capacity) {
+  if (capacity < 1)
+    return NULL;
+  // 테이블은 항목 수의 2배 이상인 2의 거듭제곱 (채움률 50% 이하)
+  unsigned int tableSize = 2;
+  while (tableSize < 2u * (unsigned int)capacity)
+    tableSize <<= 1;
+
+  LruCache *cache = (LruCache *)calloc(1, sizeof(LruCache));
+  if (cache == NULL)
+    return NULL;
+  cache->nodes = (Node *)malloc(sizeof(Node) * capacity);
+  cache->records = (CacheRecord *)malloc(sizeof(CacheRecord) * capacity);
+  cache->table = (Node **)calloc(tableSize, sizeof(Node *));
+  if (cache->nodes == NULL || cache->records == NULL || cache->table == NULL) {
+    freeLruCache(cache);
+    return NULL;
+  }
+  cache->tableMask = tableSize - 1;
+  cache->capacity = capacity;
+  return cache;
+}
+
+/**
+ * @brief 키로 레코드를 조회함. 찾으면 그 노드를 맨 앞으로 옮김 (O(1))
+ * @param cache: 캐시 포인터
+ * @param key: 조회할 키
+ * @return 찾은 레코드의 포인터 (다음 lruPut 전까지 유효), 없으면 NULL 반환
+ */
+const CacheRecord *lruGet(LruCache *cache, int key) {
+  Node *node = cache->table[lruFindSlot(cache, key)];
+  if (node == NULL) {
+    cache->misses++;
+    return NULL;
+  }
+  cache->hits++;
+  if (node != cache->head) {
+    lruDetach(cache, node);
+    lruPushFront(cache, node);
+  }
+  return &cache->records[node - cache->nodes];
+}
+
+/**
+ * @brief 키와 레코드를 저장하고 맨 앞으로 옮김. 새 키인데 가득 차 있으면 맨 뒤
+ * 항목을 내보냄 (O(1))
+ * @param cache: 캐시 포인터
+ * @param key: 저장할 키
+ * @param record: 저장할 레코드 (복사됨)
+ */
+void lruPut(LruCache *cache, int key, const CacheRecord *record) {
+  unsigned int slot = lruFindSlot(cache, key);
+  Node *node = cache->table[slot];
+  if (node != NULL) {
+    // 이미 있는 키: 레코드만 바꾸고 맨 앞으로
+    lruDetach(cache, node);
+  } else {
+    if (cache->size < cache->capacity) {
+      node = &cache->nodes[cache->size++];
+    } else {
+      // 가득 참: 가장 오래 전에 사용한 맨 뒤 노드를 다시 씀
+      node = cache->tail;
+      lruDetach(cache, node);
+      lruRemoveKey(cache, node->data);
+      cache->evictions++;
+      slot = lruFindSlot(cache, key); // 당겨진 항목 때문에 빈칸이 바뀔 수 있음
+    }
+    node->data = key;
+    node->deleted = 0;
+    cache->table[slot] = node;
+  }
+  cache->records[node - cache->nodes] = *record;
+  lruPushFront(cache, node);
+}
+
+/**
+ * @brief 캐시 항목을 최근 사용 순서로 출력하고 조회 통계를 출력함
+ * @param cache: 캐시 포인터
+ */
+void printLruCache(const LruCache *cache) {
+  printf("[최근 사용 순서] ");
+  for (Node *temp = cache->head; temp != NULL; temp = temp->next) {
+    const CacheRecord *record = &cache->records[temp - cache->nodes];
+    printf("%d:{ %s %d } ", temp->data, record->name, record->count);
+  }
+  printf("\n(%d/%d 개, 적중 %ld, 실패 %ld, 교체 %ld)\n", cache->size,
+         cache->capacity, cache->hits, cache->misses, cache->evictions);
+}
+
+/**
+ * @brief 캐시의 노드, 레코드, 해시 테이블을 모두 해제함
+ * @param cache: 해제할 캐시 포인터
+ */
+void freeLruCache(LruCache *cache) {
+  if (cache == NULL)
+    return;
+  free(cache->nodes); // 노드는 한 번에 할당했으므로 배열째 해제
+  free(cache->records);
+  free(cache->table);
+  free(cache);
+}
+
+/**
+ * @brief 키를 입력받아 조회/저장하는 대화형 LRU 캐시 모드
+ * @param capacity: 캐시 크기
+ * @return 성공 시 0, 실패 시 1 반환 (main 의 반환값으로 사용)
+ */
+int runLruMode(int capacity) {
+  LruCache *cache = createLruCache(capacity);
+  if (cache == NULL) {
+    fprintf(stderr, "오류: 캐시 생성 실패! (크기 %d)\n", capacity);
+    return 1;
+  }
+  int choice;
+  int key;
+  CacheRecord record;
+  while (1) {
+    printf("\n");
+    printLruCache(cache);
+    printf("\n원하는 작업을 선택하세요:\n");
+    printf("1: 조회 (키)\n");
+    printf("2: 저장 (키, 이름, 카톡 횟수)\n");
+    printf("0: 종료\n");
+    printf("번호를 입력하세요: ");
+    if (scanf("%d", &choice) != 1 || choice == 0)
+      break;
+    switch (choice) {
+    case 1: {
+      printf("조회할 키를 입력하세요: ");
+      if (scanf("%d", &key) != 1)
+        break;
+      const CacheRecord *found = lruGet(cache, key);
+      if (found != NULL)
+        printf("적중: %d -> { %s %d }\n", key, found->name, found->count);
+      else
+        printf("캐시에 없는 키입니다.\n");
+      break;
+    }
+    case 2:
+      printf("저장할 키, 이름, 카톡 횟수를 입력하세요: ");
+      if (scanf("%d %19s %d", &key, record.name, &record.count) != 3) {
+        printf("잘못된 입력입니다.\n");
+        break;
+      }
+      lruPut(cache, key, &record);
+      break;
+    default:
+      printf("잘못된 선택입니다.\n");
+      break;
+    }
+  }
+  freeLruCache(cache);
+  return 0;
+}
+
+/**
+ * @brief 키 0 ~ keyCount-1 에 대한 Zipf(지수 1) 분포 접근 기록을 만듦.
+ * 순위 r(1부터) 의 확률은 1/r 에 비례하고, 인기 순위와 키가 겹치지 않도록
+ * 키를 섞어서 배정함
+ * @param keyCount: 키 개수
+ * @param length: 접근 기록 길이
+ * @param seed: 난수 시드
+ * @return 접근 기록 배열 (호출자가 free), 실패 시 NULL 반환
+ */
+int *buildZipfTrace(int keyCount, int length, unsigned int seed) {
+  double *cdf = (double *)malloc(sizeof(double) * keyCount);
+  int *keys = (int *)malloc(sizeof(int) * keyCount);
+  int *trace = (int *)malloc(sizeof(int) * length);
+  if (cdf == NULL || keys == NULL || trace == NULL) {
+    free(cdf);
+    free(keys);
+    free(trace);
+    return NULL;
+  }
+  double total = 0.0;
+  for (int i = 0; i < keyCount; i++) {
+    total += 1.0 / (i + 1);
+    cdf[i] = total;
+    keys[i] = i;
+  }
+  for (int i = keyCount - 1; i > 0; i--) {
+    int j = (int)(benchRandom(&seed) % (unsigned int)(i + 1));
+    int t = keys[i];
+    keys[i] = keys[j];
+    keys[j] = t;
+  }
+  // 균등 난수를 누적 분포에서 이분 탐색해 순위를 고름
+  for (int n = 0; n < length; n++) {
+    double u = benchRandom(&seed) / 4294967296.0 * total;
+    int low = 0;
+    int high = keyCount - 1;
+    while (low < high) {
+      int mid = (low + high) / 2;
+      if (cdf[mid] < u)
+        low = mid + 1;
+      else
+        high = mid;
+    }
+    trace[n] = keys[low];
+  }
+  free(cdf);
+  free(keys);
+  return trace;
+}
+
+/**
+ * @brief 캐시 실패 시 원본에서 읽어 오는 레코드를 흉내 냄 (키로 결정됨)
+ * @param key: 키
+ * @param record: 결과를 저장할 레코드
+ */
+void loadRecord(int key, CacheRecord *record) {
+  snprintf(record->name, sizeof(record->name), "c%d", key);
+  record->count = key % 97;
+}
+
+/**
+ * @brief Zipf 분포 접근 기록으로 캐시 크기별 적중률과 처리량을 측정함
+ * @return 성공 시 0, 실패 시 1 반환 (main 의 반환값으로 사용)
+ */
+int runLruBenchmark(void) {
+  const int keyCount = 100000;
+  const int length = 2000000;
+  const int capacities[] = {100, 1000, 5000, 10000, 25000};
+  int *trace = buildZipfTrace(keyCount, length, 4242u);
+  if (trace == NULL) {
+    fprintf(stderr, "오류: 벤치마크 메모리 할당 실패!\n");
+    return 1;
+  }
+  printf("LRU 캐시 벤치마크: 키 %d 개, Zipf(지수 1) 접근 %d 번 "
+         "(실패하면 읽어 와서 저장)\n",
+         keyCount, length);
+  for (int c = 0; c < (int)(sizeof(capacities) / sizeof(capacities[0])); c++) {
+    LruCache *cache = createLruCache(capacities[c]);
+    if (cache == NULL) {
+      fprintf(stderr, "오류: 캐시 생성 실패!\n");
+      free(trace);
+      return 1;
+    }
+    CacheRecord record;
+    long wrong = 0; // 키와 맞지 않는 레코드를 돌려준 횟수 (0이어야 함)
+    clock_t start = clock();
+    for (int n = 0; n < length; n++) {
+      const CacheRecord *found = lruGet(cache, trace[n]);
+      if (found == NULL) {
+        loadRecord(trace[n], &record);
+        lruPut(cache, trace[n], &record);
+      } else if (found->count != trace[n] % 97) {
+        wrong++;
+      }
+    }
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    printf("  크기 %6d: 적중률 %5.1f%% (적중 %ld, 실패 %ld, 교체 %ld), "
+           "%7.1f ns/접근%s\n",
+           cache->capacity, 100.0 * cache->hits / length, cache->hits,
+           cache->misses, cache->evictions, seconds * 1e9 / length,
+           wrong ? " - 잘못된 레코드 발견!" : "");
+    freeLruCache(cache);
+  }
+  free(trace);
+  return 0;
+}
+
+int main(int argc, char *argv[]) {
+  int choice;
+  Command cmd;
+
+  // 명령행 옵션: 벤치마크 실행 후 종료
+  if (argc > 1 && strcmp(argv[1], "--bench-delete") == 0)
+    return runDeleteBenchmark();
+  if (argc > 1 && strcmp(argv[1], "--bench-defrag") == 0)
+    return runDefragBenchmark();
+  if (argc > 1 && strcmp(argv[1], "--bench-pipeline") == 0)
+    return runPipelineBenchmark();
+  if (argc > 1 && strcmp(argv[1], "--bench-lru") == 0)
+    return runLruBenchmark();
+  // 파이프라인 모드: 메뉴 없이 표준 입력의 명령을 한꺼번에 처리
+  if (argc > 1 && strcmp(argv[1], "--pipeline") == 0)
+    return runPipelineMode();
+  // LRU 캐시 모드: --lru [캐시 크기]
+  if (argc > 1 && strcmp(argv[1], "--lru") == 0)
+    return runLruMode(argc > 2 ? atoi(argv[2]) : LRU_DEFAULT_CAPACITY);
+
+  // 저장된 리스트가 있으면 복원, 없으면 초기값으로 시작
+  Journal *journal = openJournal(JOURNAL_PATH, SNAPSHOT_PATH,
+                                 JOURNAL_GROUP_SIZE, JOURNAL_COMPACT_THRESHOLD);
+  if (journal == NULL)
+    fprintf(stderr, "경고: 저널 생성 실패! 변경 내용이 저장되지 않습니다.\n");
+  Node *head = loadList(journal);
+
+  printf("\n[초기 리스트] ");
+  printList(head);
+
+  while (1) {
+    // 각 기능 실행 후 리스트 출력
+    printf("\n[현재 리스트] ");
+    printList(head);
+    printf("\n");
+
+    printf("\n원하는 작업을 선택하세요:\n");
+    printf("1: 맨 앞에 삽입\n");
+    printf("2: 원하는 위치에 삽입\n");
+    printf("3: 맨 뒤에 삽입\n");
+    printf("4: 원하는 위치 삭제\n");
+    printf("5: 지연 삭제 모드 전환 (현재: %s)\n", lazyDelete ? "켜짐" : "꺼짐");
+    printf("6: 리스트 재배치 (메모리 조각 모음)\n");
+    printf("0: 종료\n");
+    printf("번호를 입력하세요: ");
+    if (scanf("%d", &choice) != 1) {
+      while (getchar() != '\n')
+        ;
+      printf("잘못된 입력입니다.\n");
+      break;
+    }
+    if (choice == 0)
+      break;
+    cmd.op = choice;
+    cmd.value = 0;
+    cmd.index = 0;
+    switch (choice) {
+    case 1:
+      printf("맨 앞에 삽입할 값을 입력하세요: ");
+      scanf("%d", &cmd.value);
+      applyCommand(&head, journal, &cmd);
+      break;
+    case 2:
+      printf("삽입할 값을 입력하세요: ");
+      scanf("%d", &cmd.value);
+      printf("삽입할 위치(인덱스)를 입력하세요: ");
+      scanf("%d", &cmd.index);
+      if (!applyCommand(&head, journal, &cmd))
+        printf("잘못된 인덱스입니다.\n");
+      break;
+    case 3:
+      printf("맨 뒤에 삽입할 값을 입력하세요: ");
+      scanf("%d", &cmd.value);
+      applyCommand(&head, journal, &cmd);
+      break;
+    case 4:
+      printf("삭제할 위치(인덱스)를 입력하세요: ");
+      scanf("%d", &cmd.index);
+      if (!applyCommand(&head, journal, &cmd))
+        printf("잘못된 인덱스입니다.\n");
+      break;
+    case 5:
+      applyCommand(&head, journal, &cmd);
+      printf("지연 삭제 모드를 %s.\n", lazyDelete ? "켰습니다" : "껐습니다");
+      break;
+    case 6:
+      if (!applyCommand(&head, journal, &cmd))
+        printf("재배치 실패. 메모리가 부족할 수 있습니다.\n");
       break;
     default:
       printf("잘못된 선택입니다.\n");
       break;
     }
   }
+  closeJournal(journal); // 남은 저널 레코드 fsync 후 닫기
   freeList(head);
   return 0;
 }